@@ -0,0 +1,160 @@
+/**
+ * Shared helpers for the host-side benchmarks
+ *
+ * ReferenceLife is the original byte-per-cell, column-major kernel from
+ * main.cpp (calculate_generation + mark_changes) and is the baseline every
+ * engine is checked and timed against.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <vector>
+
+inline uint64_t now_us() {
+    using namespace std::chrono;
+    return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+// Same LCG as the firmware so soups are reproducible
+struct BenchRand {
+    uint32_t seed;
+    explicit BenchRand(uint32_t s) : seed(s) {}
+    uint32_t next() {
+        seed = seed * 1103515245 + 12345;
+        return (seed >> 16) & 0x7FFF;
+    }
+};
+
+// Abort the benchmark if an engine disagrees with the reference
+#define BENCH_CHECK(cond, ...) do { \
+    if (!(cond)) { \
+        fprintf(stderr, "CHECK FAILED %s:%d: ", __FILE__, __LINE__); \
+        fprintf(stderr, __VA_ARGS__); \
+        fprintf(stderr, "\n"); \
+        exit(1); \
+    } \
+} while (0)
+
+class ReferenceLife {
+public:
+    ReferenceLife(int w, int h) : w(w), h(h), grid{std::vector<uint8_t>(w * h), std::vector<uint8_t>(w * h)},
+                                  change_mask(w * h) {}
+
+    void set(int x, int y) { grid[fnow][x * h + y] = 1; }
+    uint8_t state(int x, int y) const { return grid[fnow][x * h + y]; }
+
+    void calculate_generation() {
+        const uint8_t* grid_now = grid[fnow].data();
+        uint8_t* grid_next = grid[1 - fnow].data();
+
+        for (int x = 1; x < w - 1; x++) {
+            int idx = x * h;
+            for (int y = 1; y < h - 1; y++) {
+                int idx_curr = idx + y;
+                int idx_up = idx_curr - h;
+                int idx_down = idx_curr + h;
+
+                int neighbors = 0;
+                if (grid_now[idx_up - 1] == 1) neighbors++;
+                if (grid_now[idx_up] == 1) neighbors++;
+                if (grid_now[idx_up + 1] == 1) neighbors++;
+                if (grid_now[idx_curr - 1] == 1) neighbors++;
+                if (grid_now[idx_curr + 1] == 1) neighbors++;
+                if (grid_now[idx_down - 1] == 1) neighbors++;
+                if (grid_now[idx_down] == 1) neighbors++;
+                if (grid_now[idx_down + 1] == 1) neighbors++;
+
+                if (grid_now[idx_curr] == 1) {
+                    grid_next[idx_curr] = (neighbors >= 2 && neighbors <= 3) ? 1 : 2;
+                } else {
+                    grid_next[idx_curr] = (neighbors == 3) ? 1 : 0;
+                }
+            }
+        }
+    }
+
+    void mark_changes() {
+        const uint8_t* grid_now = grid[fnow].data();
+        const uint8_t* grid_next = grid[1 - fnow].data();
+        for (int i = 0; i < w * h; i++) {
+            change_mask[i] = (grid_now[i] != grid_next[i]) ? grid_next[i] : 255;
+        }
+    }
+
+    void swap() { fnow = 1 - fnow; }
+
+    void step() {
+        calculate_generation();
+        swap();
+    }
+
+    int w, h;
+    std::vector<uint8_t> grid[2];
+    std::vector<uint8_t> change_mask;
+    int fnow = 0;
+};
+
+// Scatter `dots` random cells over the interior, as init_life_grid() does
+template <typename Grid>
+void seed_soup(Grid& g, int w, int h, int dots, uint32_t seed) {
+    BenchRand r(seed);
+    for (int i = 0; i < dots; i++) {
+        int x = 1 + (r.next() % (w - 2));
+        int y = 1 + (r.next() % (h - 2));
+        g.set(x, y);
+    }
+}
+
+// Stand-in for the 320x240 RGB565 PicoGraphics framebuffer
+struct HostFramebuffer {
+    static constexpr int WIDTH = 320;
+    static constexpr int HEIGHT = 240;
+
+    // Big-endian RGB565, as the firmware pens end up in memory
+    static constexpr uint16_t BLACK = 0x0000;
+    static constexpr uint16_t WHITE = 0xFFFF;
+    static constexpr uint16_t RED = 0x00F8;
+
+    std::vector<uint16_t> pixels = std::vector<uint16_t>(WIDTH * HEIGHT);
+
+    void rectangle(int x, int y, int w, int h, uint16_t colour) {
+        for (int j = y; j < y + h && j < HEIGHT; j++) {
+            for (int i = x; i < x + w && i < WIDTH; i++) {
+                pixels[j * WIDTH + i] = colour;
+            }
+        }
+    }
+
+    static uint16_t state_colour(uint8_t state) {
+        return state == 1 ? WHITE : state == 2 ? RED : BLACK;
+    }
+};
+
+// Stand-in for the ST7789: keeps its own copy of the panel and counts the
+// bytes a frame costs on the bus, including the CASET/RASET/RAMWR
+// commands that open each window
+struct CountingDisplay {
+    static constexpr int WINDOW_OVERHEAD = 11;
+
+    std::vector<uint16_t> panel = std::vector<uint16_t>(HostFramebuffer::WIDTH * HostFramebuffer::HEIGHT);
+    uint64_t bytes = 0;
+    uint64_t windows = 0;
+
+    void update(const HostFramebuffer& fb) {
+        partial_update(fb, 0, 0, HostFramebuffer::WIDTH, HostFramebuffer::HEIGHT);
+    }
+
+    void partial_update(const HostFramebuffer& fb, int x, int y, int w, int h) {
+        for (int j = y; j < y + h; j++) {
+            for (int i = x; i < x + w; i++) {
+                panel[j * HostFramebuffer::WIDTH + i] = fb.pixels[j * HostFramebuffer::WIDTH + i];
+            }
+        }
+        bytes += (uint64_t)w * h * 2 + WINDOW_OVERHEAD;
+        windows++;
+    }
+};
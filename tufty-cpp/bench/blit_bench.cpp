@@ -0,0 +1,95 @@
+/**
+ * Direct cell blitter vs pen + rectangle drawing
+ *
+ * PenGraphics models the PicoGraphics path the firmware used: a virtual
+ * set_pen(), then rectangle() clipping the Rect and filling it a span at a
+ * time through a virtual call. blit_cell<3>() writes the 3x3 block
+ * directly. Both draw the same random change sets into a 320x240 RGB565
+ * buffer, which must match, and cells drawn per microsecond is reported
+ * at several change densities.
+ */
+
+#include <algorithm>
+#include "bench.hpp"
+#include "life_render.hpp"
+
+constexpr int LIFE_X = 106;
+constexpr int LIFE_Y = 80;
+constexpr int LIFE_SIZE = 3;
+constexpr int WIDTH = HostFramebuffer::WIDTH;
+constexpr int HEIGHT = HostFramebuffer::HEIGHT;
+
+struct Change {
+    int x, y;
+    uint8_t state;
+};
+
+class PenGraphics {
+public:
+    explicit PenGraphics(uint16_t* fb) : fb(fb) {}
+    virtual ~PenGraphics() {}
+
+    virtual void set_pen(uint16_t c) { colour = c; }
+
+    virtual void set_pixel_span(int x, int y, int l) {
+        uint16_t* p = fb + y * WIDTH + x;
+        while (l--) *p++ = colour;
+    }
+
+    void rectangle(int x, int y, int w, int h) {
+        int x0 = std::max(x, 0), y0 = std::max(y, 0);
+        int x1 = std::min(x + w, WIDTH), y1 = std::min(y + h, HEIGHT);
+        if (x1 <= x0 || y1 <= y0) return;
+        for (int j = y0; j < y1; j++) set_pixel_span(x0, j, x1 - x0);
+    }
+
+private:
+    uint16_t* fb;
+    uint16_t colour = 0;
+};
+
+int main() {
+    const int densities[] = {1, 5, 20, 50, 100};
+    const int REPEATS = 200;
+
+    printf("density   cells   rectangle cells/us   blit cells/us   speedup\n");
+    for (int pct : densities) {
+        // A random change set covering pct% of the grid, in scanline order
+        BenchRand r(pct);
+        std::vector<Change> changes;
+        for (int y = 0; y < LIFE_Y; y++) {
+            for (int x = 0; x < LIFE_X; x++) {
+                if ((int)(r.next() % 100) < pct) changes.push_back({x, y, (uint8_t)(r.next() % 3)});
+            }
+        }
+
+        HostFramebuffer fb_rect, fb_blit;
+        PenGraphics* graphics = new PenGraphics(fb_rect.pixels.data());
+
+        uint64_t t0 = now_us();
+        for (int rep = 0; rep < REPEATS; rep++) {
+            for (const Change& c : changes) {
+                graphics->set_pen(LIFE_PALETTE[c.state]);
+                graphics->rectangle(c.x * LIFE_SIZE, c.y * LIFE_SIZE, LIFE_SIZE, LIFE_SIZE);
+            }
+        }
+        uint64_t rect_us = now_us() - t0;
+
+        t0 = now_us();
+        for (int rep = 0; rep < REPEATS; rep++) {
+            for (const Change& c : changes) {
+                blit_cell<LIFE_SIZE>(fb_blit.pixels.data(), WIDTH, c.x, c.y, LIFE_PALETTE[c.state]);
+            }
+        }
+        uint64_t blit_us = now_us() - t0;
+        delete graphics;
+
+        BENCH_CHECK(fb_rect.pixels == fb_blit.pixels, "framebuffers differ at %d%%", pct);
+
+        double cells = (double)changes.size() * REPEATS;
+        printf("  %3d%%   %5zu   %18.1f   %13.1f   x%.2f\n", pct, changes.size(),
+               cells / (double)(rect_us ? rect_us : 1), cells / (double)(blit_us ? blit_us : 1),
+               (double)rect_us / (double)(blit_us ? blit_us : 1));
+    }
+    return 0;
+}
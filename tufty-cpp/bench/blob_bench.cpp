@@ -0,0 +1,237 @@
+/**
+ * Images shown in place from the memory-mapped blob
+ *
+ * Packs the PNGs in test_images/ and their .565 conversions into an
+ * image blob, mmap()s it as the badge maps flash through XIP, and checks
+ * that ImageBlob finds every entry and that decoding a PNG or taking a
+ * .565's pixels in place gives the same framebuffer as reading the file
+ * through a filesystem first. Reports, per image, the bytes the loader
+ * copies out of storage and the latency for both routes.
+ *
+ *     blob_bench [filesystem.blob.bin]
+ *
+ * also checks a blob written by build_filesystem.py --blob.
+ */
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+#include "bench.hpp"
+#include "host_png.hpp"
+#include "image565.hpp"
+#include "image_blob.hpp"
+
+#ifndef TEST_IMAGE_DIR
+#define TEST_IMAGE_DIR "test_images"
+#endif
+
+constexpr int W = HostFramebuffer::WIDTH;
+constexpr int H = HostFramebuffer::HEIGHT;
+
+const char* const IMAGES[] = {"tufty-name", "tufty1", "tufty2", "tufty3", "tufty4", "tufty5"};
+
+void put32(std::vector<uint8_t>& out, size_t at, uint32_t v) {
+    for (int i = 0; i < 4; i++) out[at + i] = (uint8_t)(v >> (8 * i));
+}
+
+// The layout build_blob() in build_filesystem.py writes
+std::vector<uint8_t> pack_blob(const std::vector<std::pair<std::string, std::vector<uint8_t>>>& entries) {
+    size_t offset = (ImageBlob::HEADER + ImageBlob::ENTRY * entries.size() + 3) & ~(size_t)3;
+    std::vector<uint8_t> blob(offset);
+    memcpy(blob.data(), "TBLB", 4);
+    put32(blob, 4, IMAGE_BLOB_VERSION);
+    put32(blob, 8, (uint32_t)entries.size());
+    for (size_t i = 0; i < entries.size(); i++) {
+        size_t e = ImageBlob::HEADER + i * ImageBlob::ENTRY;
+        memcpy(&blob[e], entries[i].first.c_str(), entries[i].first.size());
+        put32(blob, e + ImageBlob::NAME, (uint32_t)blob.size());
+        put32(blob, e + ImageBlob::NAME + 4, (uint32_t)entries[i].second.size());
+        blob.insert(blob.end(), entries[i].second.begin(), entries[i].second.end());
+        blob.resize((blob.size() + 3) & ~(size_t)3);
+    }
+    put32(blob, 12, (uint32_t)blob.size());
+    return blob;
+}
+
+// A read-only mapping of a file, as XIP maps flash
+struct Mapping {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+
+    explicit Mapping(const std::string& path) {
+        int fd = open(path.c_str(), O_RDONLY);
+        BENCH_CHECK(fd >= 0, "cannot open %s", path.c_str());
+        size = (size_t)lseek(fd, 0, SEEK_END);
+        void* p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        BENCH_CHECK(p != MAP_FAILED, "cannot map %s", path.c_str());
+        data = (const uint8_t*)p;
+    }
+    ~Mapping() { munmap((void*)data, size); }
+};
+
+// A file read through the filesystem in PNGdec-sized pieces, counting the
+// bytes copied out of storage
+struct StorageFile {
+    int fd;
+    size_t copied = 0;
+
+    explicit StorageFile(const std::string& path) : fd(open(path.c_str(), O_RDONLY)) {
+        BENCH_CHECK(fd >= 0, "cannot open %s", path.c_str());
+    }
+    ~StorageFile() { close(fd); }
+
+    void read(void* dst, size_t size) {
+        for (size_t at = 0; at < size;) {
+            ssize_t n = ::read(fd, (uint8_t*)dst + at, size - at < 2048 ? size - at : 2048);
+            BENCH_CHECK(n > 0, "short read");
+            at += (size_t)n;
+        }
+        copied += size;
+    }
+};
+
+std::vector<uint8_t> read_file(const std::string& path) {
+    Mapping m(path);
+    return std::vector<uint8_t>(m.data, m.data + m.size);
+}
+
+// Best of several interleaved runs of a and b, in microseconds
+template <typename A, typename B>
+void best_us(A&& a, B&& b, double& a_us, double& b_us) {
+    a_us = b_us = 1e30;
+    for (int run = 0; run < 15; run++) {
+        uint64_t t0 = now_us();
+        a();
+        uint64_t t1 = now_us();
+        b();
+        uint64_t t2 = now_us();
+        if (t1 - t0 < a_us) a_us = (double)(t1 - t0);
+        if (t2 - t1 < b_us) b_us = (double)(t2 - t1);
+    }
+}
+
+// Every entry of a blob must show the same framebuffer as its PNG
+void check_blob(const ImageBlob& blob) {
+    std::vector<uint8_t> rgb;
+    for (int i = 0; i < blob.count(); i++) {
+        std::string name = blob.name(i);
+        std::string stem = name.substr(0, name.size() - 4);
+        HostFramebuffer want, got;
+        BENCH_CHECK(decode_png(read_file(std::string(TEST_IMAGE_DIR) + "/" + stem + ".png"), want, rgb),
+                    "%s.png did not decode", stem.c_str());
+        if (image565_name(name.c_str())) {
+            Image565Info info;
+            const uint8_t* pixels = image565_pixels(blob.data(i), blob.size(i), info);
+            BENCH_CHECK(pixels && info.width == W && info.height == H, "%s: not a full-screen .565", name.c_str());
+            BENCH_CHECK(memcmp(pixels, want.pixels.data(), info.bytes()) == 0, "%s differs from %s.png", name.c_str(),
+                        stem.c_str());
+        } else {
+            BENCH_CHECK(decode_png(blob.data(i), blob.size(i), got, rgb), "%s did not decode", name.c_str());
+            BENCH_CHECK(got.pixels == want.pixels, "%s differs from %s.png", name.c_str(), stem.c_str());
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc > 1) {
+        Mapping m(argv[1]);
+        ImageBlob blob;
+        BENCH_CHECK(blob.open(m.data, (uint32_t)m.size), "%s is not an image blob", argv[1]);
+        check_blob(blob);
+        printf("  %s: %d entries match their PNGs\n", argv[1], blob.count());
+    }
+
+    // The test images as PNG and .565 files, and packed into a blob
+    char dir[] = "/tmp/blob_benchXXXXXX";
+    BENCH_CHECK(mkdtemp(dir), "cannot make a temporary directory");
+    std::vector<std::pair<std::string, std::vector<uint8_t>>> entries;
+    std::vector<uint8_t> rgb;
+    for (const char* name : IMAGES) {
+        std::vector<uint8_t> png = read_file(std::string(TEST_IMAGE_DIR) + "/" + name + ".png");
+        HostFramebuffer fb;
+        BENCH_CHECK(decode_png(png, fb, rgb), "%s.png did not decode to %dx%d", name, W, H);
+        std::vector<uint8_t> raw(IMAGE565_HEADER + W * H * 2);
+        const uint8_t header[IMAGE565_HEADER] = {'R', '5', '6', '5', W & 0xFF, W >> 8, H & 0xFF, H >> 8};
+        memcpy(raw.data(), header, IMAGE565_HEADER);
+        memcpy(raw.data() + IMAGE565_HEADER, fb.pixels.data(), W * H * 2);
+        entries.push_back({std::string(name) + ".png", png});
+        entries.push_back({std::string(name) + ".565", raw});
+    }
+    for (const auto& e : entries) {
+        FILE* f = fopen((std::string(dir) + "/" + e.first).c_str(), "wb");
+        fwrite(e.second.data(), 1, e.second.size(), f);
+        fclose(f);
+    }
+    std::string blob_path = std::string(dir) + "/images.blob.bin";
+    std::vector<uint8_t> packed = pack_blob(entries);
+    FILE* f = fopen(blob_path.c_str(), "wb");
+    fwrite(packed.data(), 1, packed.size(), f);
+    fclose(f);
+
+    Mapping mapped(blob_path);
+    ImageBlob blob;
+    BENCH_CHECK(blob.open(mapped.data, (uint32_t)mapped.size), "packed blob does not open");
+    BENCH_CHECK(blob.count() == (int)entries.size(), "%d entries, packed %zu", blob.count(), entries.size());
+    BENCH_CHECK(!blob.open(mapped.data, (uint32_t)mapped.size - 1), "blob opened past the end of its region");
+    BENCH_CHECK(blob.open(mapped.data, (uint32_t)mapped.size), "packed blob does not reopen");
+    check_blob(blob);
+    printf("Blob entries match their files\n");
+
+    printf("entry            filesystem: copied   latency     blob: copied   latency\n");
+    size_t fs_total = 0;
+    for (const auto& e : entries) {
+        const std::string path = std::string(dir) + "/" + e.first;
+        int i = blob.find(e.first.c_str());
+        BENCH_CHECK(i >= 0, "%s not in the blob", e.first.c_str());
+        bool raw = image565_name(e.first.c_str());
+        HostFramebuffer fb;
+        std::vector<uint8_t> file(e.second.size());
+
+        // Through the filesystem: a PNG is read into the decoder's buffer,
+        // a .565 straight into the framebuffer, as load_raw565() does
+        size_t fs_copied = 0;
+        auto through_fs = [&] {
+            StorageFile storage(path);
+            if (raw) {
+                uint8_t header[IMAGE565_HEADER];
+                Image565Info info;
+                storage.read(header, sizeof(header));
+                BENCH_CHECK(image565_header(header, info), "%s: bad header", path.c_str());
+                storage.read(fb.pixels.data(), info.bytes());
+            } else {
+                storage.read(file.data(), file.size());
+                decode_png(file, fb, rgb);
+            }
+            fs_copied = storage.copied;
+        };
+
+        // In place: nothing is copied out of the mapping; the decoder or
+        // the display reads it where it is
+        const uint8_t* shown = nullptr;
+        auto in_place = [&] {
+            if (raw) {
+                Image565Info info;
+                shown = image565_pixels(blob.data(i), blob.size(i), info);
+            } else {
+                decode_png(blob.data(i), blob.size(i), fb, rgb);
+                shown = (const uint8_t*)fb.pixels.data();
+            }
+        };
+        double fs_us, blob_us;
+        best_us(through_fs, in_place, fs_us, blob_us);
+        BENCH_CHECK(shown, "%s: nothing to show", e.first.c_str());
+        fs_total += fs_copied;
+        printf("%-16s %17zu %7.1f us %14d %7.1f us\n", e.first.c_str(), fs_copied, fs_us, 0, blob_us);
+    }
+    printf("per image        %17zu              %14d\n", fs_total / entries.size(), 0);
+
+    for (const auto& e : entries) unlink((std::string(dir) + "/" + e.first).c_str());
+    unlink(blob_path.c_str());
+    rmdir(dir);
+    return 0;
+}
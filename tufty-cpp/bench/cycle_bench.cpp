@@ -0,0 +1,196 @@
+/**
+ * Incremental board hash and cycle detection
+ *
+ * Checks that BitLife's incrementally maintained hash always equals one
+ * computed from scratch and is updated once per rewritten word, that
+ * known oscillators are reported with their period as soon as it has
+ * elapsed, and that on random soups the detector agrees with comparing
+ * whole boards. Then reports what hashing and detection cost per
+ * generation, the kernel's hash updates for the words it rewrites timed
+ * on their own.
+ */
+
+#include <memory>
+#include <vector>
+#include "bench.hpp"
+#include "life.hpp"
+#include "life_lut.hpp"
+#include "life_cycle.hpp"
+#include "life_pattern.hpp"
+
+constexpr int CYCLE_MAX = 16;
+
+template <typename Grid>
+uint64_t full_hash(const Grid& grid) {
+    typename Grid::Plane plane;
+    grid.snapshot(plane);
+    LifeHash h;
+    for (int y = 0; y < Grid::SH; y++) {
+        for (int k = 0; k < Grid::WORDS; k++) h.update(0, plane[y][k], y * Grid::WORDS + k);
+    }
+    return h.value();
+}
+
+template <typename Grid>
+void check_hash(const char* name) {
+    auto life = std::make_unique<Grid>();
+    life->clear();
+    BENCH_CHECK(life->hash() == 0, "%s: empty grid hash", name);
+    seed_soup(*life, Grid::WIDTH, Grid::HEIGHT, Grid::WIDTH * Grid::HEIGHT / 4, 21);
+    BENCH_CHECK(life->hash() == full_hash(*life), "%s: hash after seeding", name);
+    typename Grid::Plane before, after;
+    for (int g = 0; g < 400; g++) {
+        life->snapshot(before);
+        life->step();
+        BENCH_CHECK(life->hash() == full_hash(*life), "%s: hash at gen %d", name, g);
+        life->snapshot(after);
+        int rewritten = 0;
+        for (int y = 0; y < Grid::SH; y++) {
+            for (int k = 0; k < Grid::WORDS; k++) rewritten += before[y][k] != after[y][k];
+        }
+        BENCH_CHECK(life->hashed_words() == rewritten, "%s gen %d: %d words hashed, %d rewritten", name, g,
+                    life->hashed_words(), rewritten);
+        if (g == 200) {
+            // Cells added mid-run, some already alive
+            seed_soup(*life, Grid::WIDTH, Grid::HEIGHT, 300, 22);
+            BENCH_CHECK(life->hash() == full_hash(*life), "%s: hash after set()", name);
+        }
+    }
+}
+
+struct Oscillator {
+    const char* name;
+    const char* rle;
+    int period;   // 0: must never be reported
+};
+
+const Oscillator OSCILLATORS[] = {
+    {"block", "2o$2o!", 1},
+    {"blinker", "3o!", 2},
+    {"toad", "b3o$3o!", 2},
+    {"beacon", "2o$2o$2b2o$2b2o!", 2},
+    {"pulsar", "2b3o3b3o2$o4bobo4bo$o4bobo4bo$o4bobo4bo$2b3o3b3o2$2b3o3b3o$o4bobo4bo$o4bobo4bo$o4bobo4bo2$2b3o3b3o!", 3},
+    {"pentadecathlon", "2bo4bo$2ob4ob2o$2bo4bo!", 15},
+    {"glider", "bob$2bo$3o!", 0},
+};
+
+void check_oscillators() {
+    using Grid = BitLife<128, 128>;
+    for (const Oscillator& o : OSCILLATORS) {
+        auto life = std::make_unique<Grid>();
+        life->clear();
+        LifePatternParser parser(LifePatternFormat::Rle);
+        parser.feed(o.rle, strlen(o.rle), [&](int x, int y) { life->set(40 + x, 40 + y); });
+
+        LifeCycleDetector<CYCLE_MAX> cycles;
+        cycles.push(life->hash(), 0);
+        int found = 0, found_at = 0;
+        // Long enough for two pentadecathlon periods, short enough that
+        // the glider stays clear of the edges
+        for (int g = 1; g <= 40 && !found; g++) {
+            life->step();
+            found = cycles.push(life->hash(), g);
+            found_at = g;
+        }
+        if (o.period) {
+            BENCH_CHECK(found == o.period, "%s: period %d, expected %d", o.name, found, o.period);
+            BENCH_CHECK(found_at == o.period && cycles.cycle_start() == 0, "%s: detected at gen %d, cycle from %u",
+                        o.name, found_at, cycles.cycle_start());
+            printf("  %-15s period %2d  detected at generation %2d\n", o.name, found, found_at);
+        } else {
+            BENCH_CHECK(found == 0, "%s: reported period %d", o.name, found);
+        }
+    }
+}
+
+// The detector against comparing the last CYCLE_MAX boards outright
+void check_soups() {
+    using Grid = BitLife<106, 80>;
+    int detected = 0;
+    for (uint32_t seed = 1; seed <= 20; seed++) {
+        auto life = std::make_unique<Grid>();
+        life->clear();
+        seed_soup(*life, Grid::WIDTH, Grid::HEIGHT, 2000, seed);
+        std::vector<std::vector<uint32_t>> history;
+        LifeCycleDetector<CYCLE_MAX> cycles;
+        for (int g = 0; g < 3000; g++) {
+            life->step();
+            Grid::Plane plane;
+            life->snapshot(plane);
+            std::vector<uint32_t> board(&plane[0][0], &plane[0][0] + Grid::SH * Grid::WORDS);
+            int expected = 0;
+            for (int p = 1; p <= (int)history.size() && !expected; p++) {
+                if (history[history.size() - p] == board) expected = p;
+            }
+            int found = cycles.push(life->hash(), g);
+            BENCH_CHECK(found == expected, "seed %u gen %d: period %d, boards say %d", seed, g, found, expected);
+            if (found) {
+                detected++;
+                break;
+            }
+            history.push_back(board);
+            if ((int)history.size() > CYCLE_MAX) history.erase(history.begin());
+        }
+    }
+    printf("  %d of 20 soups settled into a cycle of period <= %d within 3000 generations\n", detected, CYCLE_MAX);
+}
+
+void bench() {
+    using Grid = BitLife<106, 80>;
+    const int generations = 20000;
+
+    auto life = std::make_unique<Grid>();
+    life->clear();
+    life->set_skip_stable(false);
+    seed_soup(*life, Grid::WIDTH, Grid::HEIGHT, 2000, 5);
+    uint64_t hashed = 0;
+    uint64_t t0 = now_us();
+    for (int g = 0; g < generations; g++) {
+        life->step();
+        hashed += life->hashed_words();
+    }
+    uint64_t step_us = now_us() - t0;
+
+    // The updates the kernel does for the words it rewrites, timed on
+    // their own as main() does to report them
+    LifeHash h;
+    t0 = now_us();
+    for (uint32_t i = 0; i < hashed; i++) h.update(i * 0x9E3779B9u, ~i, i);
+    uint64_t update_us = now_us() - t0;
+    volatile uint64_t hash_sink = h.value();
+    (void)hash_sink;
+
+    // Rehashing from scratch every generation instead, for comparison
+    volatile uint64_t sink = 0;
+    t0 = now_us();
+    for (int g = 0; g < generations; g++) {
+        life->step();
+        sink = sink ^ full_hash(*life);
+    }
+    uint64_t full_us = now_us() - t0 - step_us;
+
+    LifeCycleDetector<CYCLE_MAX> cycles;
+    BenchRand r(3);
+    volatile int periods = 0;
+    t0 = now_us();
+    for (int g = 0; g < generations; g++) periods = periods + cycles.push(r.next() | (uint64_t)r.next() << 32, g);
+    uint64_t push_us = now_us() - t0;
+
+    printf("106x80 soup: step with incremental hash %.2f us, of which %.2f us hashing %.0f rewritten words\n",
+           (double)step_us / generations, (double)update_us / generations, (double)hashed / generations);
+    printf("  full rehash would add %.2f us, ring check (%d) %.3f us\n", (double)full_us / generations, CYCLE_MAX,
+           (double)push_us / generations);
+}
+
+int main() {
+    check_hash<BitLife<106, 80>>("swar");
+    check_hash<BitLife<106, 80, LifeLayout::ColumnMajor>>("column-major");
+    check_hash<BitLife<106, 80, LifeLayout::RowMajor, LutKernel<>>>("lut");
+    check_hash<BitLife<256, 160>>("256x160");
+    printf("Incremental hash matches full rehash\n");
+    check_oscillators();
+    check_soups();
+    printf("Cycle detection matches board comparison\n");
+    bench();
+    return 0;
+}
@@ -0,0 +1,57 @@
+/**
+ * Dirty-window display updates vs full-frame updates
+ *
+ * Runs Life for LIFE_FRAMES frames at several soup densities, sending each
+ * frame to a CountingDisplay either as a full 320x240 update or as the
+ * windows produced by DirtyRegion. The panel contents must match the
+ * framebuffer after every frame; bytes transmitted per frame are reported.
+ */
+
+#include "bench.hpp"
+#include "life.hpp"
+#include "life_render.hpp"
+
+constexpr int LIFE_X = 106;
+constexpr int LIFE_Y = 80;
+constexpr int LIFE_SIZE = 3;
+constexpr int LIFE_FRAMES = 500;
+
+int main() {
+    const int dots_list[] = {200, 1000, 2000, 4000};
+
+    printf("%d frames per run\n", LIFE_FRAMES);
+    printf("dots    full bytes/frame   dirty bytes/frame   windows/frame   saving\n");
+    for (int dots : dots_list) {
+        HostFramebuffer fb;
+        CountingDisplay full, partial;
+        BitLife<LIFE_X, LIFE_Y> life;
+        DirtyRegion<LIFE_X, LIFE_Y, LIFE_SIZE> dirty;
+
+        life.clear();
+        seed_soup(life, LIFE_X, LIFE_Y, dots, dots);
+        for (int y = 0; y < LIFE_Y; y++) {
+            for (int x = 0; x < LIFE_X; x++) {
+                blit_cell<LIFE_SIZE>(fb.pixels.data(), HostFramebuffer::WIDTH, x, y, LIFE_PALETTE[life.state(x, y)]);
+            }
+        }
+        full.update(fb);
+        partial.update(fb);
+        full.bytes = partial.bytes = full.windows = partial.windows = 0;
+
+        for (int f = 0; f < LIFE_FRAMES; f++) {
+            life.step([&](int x, int y, uint8_t state) {
+                blit_cell<LIFE_SIZE>(fb.pixels.data(), HostFramebuffer::WIDTH, x, y, LIFE_PALETTE[state]);
+                dirty.mark(x, y);
+            });
+            full.update(fb);
+            dirty.flush([&](int x, int y, int w, int h) { partial.partial_update(fb, x, y, w, h); });
+            BENCH_CHECK(partial.panel == fb.pixels, "panel out of date at frame %d (dots %d)", f, dots);
+        }
+
+        printf("%5d   %16.0f   %17.0f   %13.2f   %5.1f%%\n", dots,
+               (double)full.bytes / LIFE_FRAMES, (double)partial.bytes / LIFE_FRAMES,
+               (double)partial.windows / LIFE_FRAMES,
+               100.0 * (1.0 - (double)partial.bytes / (double)full.bytes));
+    }
+    return 0;
+}
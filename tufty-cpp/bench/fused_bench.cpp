@@ -0,0 +1,61 @@
+/**
+ * Fused step+draw vs the original three-pass Life frame
+ *
+ * The three-pass frame runs calculate_generation(), mark_changes() and a
+ * draw_changes() sweep over change_mask. The fused frame lets
+ * BitLife::step() emit changed cells straight to the draw routine. Both
+ * render into a host framebuffer, which must stay pixel-identical every
+ * frame, and per-frame time is reported for each.
+ */
+
+#include "bench.hpp"
+#include "life.hpp"
+
+constexpr int LIFE_X = 106;
+constexpr int LIFE_Y = 80;
+constexpr int LIFE_SIZE = 3;
+constexpr int FRAMES = 500;
+
+void draw_changes(HostFramebuffer& fb, const ReferenceLife& ref) {
+    for (int x = 0; x < LIFE_X; x++) {
+        for (int y = 0; y < LIFE_Y; y++) {
+            uint8_t val = ref.change_mask[x * LIFE_Y + y];
+            if (val != 255) {
+                fb.rectangle(x * LIFE_SIZE, y * LIFE_SIZE, LIFE_SIZE, LIFE_SIZE, HostFramebuffer::state_colour(val));
+            }
+        }
+    }
+}
+
+int main() {
+    HostFramebuffer fb_three, fb_fused;
+    ReferenceLife ref(LIFE_X, LIFE_Y);
+    BitLife<LIFE_X, LIFE_Y> life;
+    life.clear();
+    seed_soup(ref, LIFE_X, LIFE_Y, 2000, 777);
+    seed_soup(life, LIFE_X, LIFE_Y, 2000, 777);
+
+    uint64_t three_us = 0, fused_us = 0;
+    for (int frame = 0; frame < FRAMES; frame++) {
+        uint64_t t0 = now_us();
+        ref.calculate_generation();
+        ref.mark_changes();
+        draw_changes(fb_three, ref);
+        ref.swap();
+        uint64_t t1 = now_us();
+        life.step([&](int x, int y, uint8_t state) {
+            fb_fused.rectangle(x * LIFE_SIZE, y * LIFE_SIZE, LIFE_SIZE, LIFE_SIZE, HostFramebuffer::state_colour(state));
+        });
+        uint64_t t2 = now_us();
+        three_us += t1 - t0;
+        fused_us += t2 - t1;
+
+        BENCH_CHECK(fb_three.pixels == fb_fused.pixels, "framebuffers differ at frame %d", frame);
+    }
+
+    printf("Framebuffers identical over %d frames\n", FRAMES);
+    printf("three-pass: %7.2f us/frame\n", (double)three_us / FRAMES);
+    printf("fused:      %7.2f us/frame  x%.1f\n", (double)fused_us / FRAMES,
+           (double)three_us / (double)(fused_us ? fused_us : 1));
+    return 0;
+}
@@ -0,0 +1,120 @@
+/**
+ * Generations engine vs a byte-per-cell reference
+ *
+ * Checks GenerationsLife against a plain simulator for several rules,
+ * including that the cells it emits reproduce the board, then reports
+ * cells/second at 2, 4 and 16 states.
+ */
+
+#include <memory>
+#include <vector>
+#include "bench.hpp"
+#include "generations.hpp"
+
+// One byte per cell, every cell visited every generation
+struct GenerationsReference {
+    int w, h;
+    uint16_t birth, survive;
+    int states;
+    std::vector<uint8_t> cur;
+
+    GenerationsReference(int w, int h, uint16_t birth, uint16_t survive, int states)
+        : w(w), h(h), birth(birth), survive(survive), states(states), cur(w * h) {}
+
+    void set(int x, int y) { cur[y * w + x] = LIFE_ALIVE; }
+    uint8_t state(int x, int y) const { return cur[y * w + x]; }
+
+    void step() {
+        std::vector<uint8_t> next(w * h);
+        for (int y = 1; y < h - 1; y++) {
+            for (int x = 1; x < w - 1; x++) {
+                int n = 0;
+                for (int dy = -1; dy <= 1; dy++) {
+                    for (int dx = -1; dx <= 1; dx++) {
+                        if (dx || dy) n += cur[(y + dy) * w + x + dx] == LIFE_ALIVE;
+                    }
+                }
+                uint8_t s = cur[y * w + x];
+                uint8_t out;
+                if (s == LIFE_DEAD) {
+                    out = (birth >> n) & 1 ? LIFE_ALIVE : LIFE_DEAD;
+                } else if (s == LIFE_ALIVE && ((survive >> n) & 1)) {
+                    out = LIFE_ALIVE;
+                } else {
+                    out = s + 1 == states ? LIFE_DEAD : s + 1;
+                }
+                next[y * w + x] = out;
+            }
+        }
+        cur.swap(next);
+    }
+};
+
+using ConwayGenerationsRule = GenerationsRule<ConwayRule::BIRTH, ConwayRule::SURVIVE, 2>;
+
+template <typename Rule, int W, int H>
+void check(int generations) {
+    GenerationsReference ref(W, H, Rule::BIRTH, Rule::SURVIVE, Rule::STATES);
+    auto life = std::make_unique<GenerationsLife<W, H>>();
+    life->clear();
+    seed_soup(ref, W, H, W * H / 4, 29);
+    seed_soup(*life, W, H, W * H / 4, 29);
+
+    // The board as redrawn from emitted cells only
+    std::vector<uint8_t> shown(W * H);
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) shown[y * W + x] = life->state(x, y);
+    }
+
+    for (int g = 0; g < generations; g++) {
+        ref.step();
+        life->template step<Rule>([&](int x, int y, uint8_t s) { shown[y * W + x] = s; });
+        for (int y = 0; y < H; y++) {
+            for (int x = 0; x < W; x++) {
+                BENCH_CHECK(ref.state(x, y) == life->state(x, y), "%dx%d %d states gen %d cell (%d,%d)", W, H,
+                            Rule::STATES, g, x, y);
+                BENCH_CHECK(shown[y * W + x] == life->state(x, y), "%dx%d %d states gen %d emitted (%d,%d)", W, H,
+                            Rule::STATES, g, x, y);
+            }
+        }
+    }
+}
+
+template <typename Rule, int W, int H>
+void bench(const char* name, int generations) {
+    GenerationsReference ref(W, H, Rule::BIRTH, Rule::SURVIVE, Rule::STATES);
+    seed_soup(ref, W, H, W * H / 4, 5);
+    uint64_t t0 = now_us();
+    for (int g = 0; g < generations; g++) ref.step();
+    uint64_t ref_us = now_us() - t0;
+
+    auto life = std::make_unique<GenerationsLife<W, H>>();
+    life->clear();
+    seed_soup(*life, W, H, W * H / 4, 5);
+    uint32_t emitted = 0;
+    t0 = now_us();
+    for (int g = 0; g < generations; g++) life->template step<Rule>([&](int, int, uint8_t) { emitted++; });
+    uint64_t gen_us = now_us() - t0;
+
+    double cells = (double)W * H * generations;
+    printf("%-24s %2d states %4dx%-4d  byte %7.1f  packed %7.1f Mcells/s  x%.1f  %5.1f%% cells redrawn\n", name,
+           Rule::STATES, W, H, cells / ref_us, cells / gen_us, (double)ref_us / gen_us, 100.0 * emitted / cells);
+}
+
+int main() {
+    check<ConwayGenerationsRule, 106, 80>(200);
+    check<BriansBrainRule, 106, 80>(200);
+    check<StarWarsRule, 106, 80>(200);
+    check<XtasyRule, 106, 80>(200);
+    check<StarWarsRule, 67, 45>(200);
+    printf("Generations engine matches reference simulator\n");
+    printf("106x80 board: %zu bytes\n", sizeof(GenerationsLife<106, 80>));
+
+    bench<ConwayGenerationsRule, 106, 80>("Conway B3/S23/2", 2000);
+    bench<StarWarsRule, 106, 80>(StarWarsRule::NAME, 2000);
+    bench<XtasyRule, 106, 80>(XtasyRule::NAME, 2000);
+    bench<ConwayGenerationsRule, 512, 512>("Conway B3/S23/2", 100);
+    bench<StarWarsRule, 512, 512>(StarWarsRule::NAME, 100);
+    bench<XtasyRule, 512, 512>(XtasyRule::NAME, 100);
+    return 0;
+}
@@ -0,0 +1,211 @@
+/**
+ * Cell age heat map
+ *
+ * Checks LifeAge over the viewport of a 320x240 universe against ages
+ * kept by brute force, a byte per cell: every generation the ages must
+ * match, and drawing only the cells it emits must leave the same
+ * framebuffer as drawing every cell from the reference, through
+ * saturation, a shrunken view and cells added with set() and synced.
+ * Then reports the per-frame cost of aging the view and drawing the
+ * cells whose colour changed, next to the plain alive/dying diff and to
+ * aging and redrawing every live cell, on a fresh soup and once it has
+ * settled.
+ */
+
+#include <memory>
+#include <vector>
+#include "bench.hpp"
+#include "life.hpp"
+#include "life_render.hpp"
+#include "life_age.hpp"
+
+constexpr int W = HostFramebuffer::WIDTH;
+constexpr int H = HostFramebuffer::HEIGHT;
+constexpr int SIZE = 3;
+constexpr int VW = W / SIZE, VH = H / SIZE;
+
+using Grid = BitLife<W, H>;
+using View = BitLife<VW, VH>;
+using Ages = LifeAge<VW, VH>;
+
+void check_palette() {
+    const LifeHeatPalette& p = LIFE_HEAT_PALETTE;
+    BENCH_CHECK(p.colour[0] == rgb565_be(0, 0, 0), "dead cells are not black");
+    int buckets = 0;
+    for (int age = 1; age < 256; age++) {
+        BENCH_CHECK(p.steps_at(age) == (p.colour[age] != p.colour[age - 1]), "steps_at(%d)", age);
+        buckets += p.steps_at(age);
+    }
+    BENCH_CHECK(p.steps_at(255), "saturated cells share a colour with younger ones");
+    BENCH_CHECK(buckets == LifeHeatPalette::BUCKETS, "%d colours for live cells, expected %d", buckets,
+                LifeHeatPalette::BUCKETS);
+}
+
+// Draw every cell of the w x h view from the reference ages
+void draw_all(HostFramebuffer& fb, const std::vector<uint8_t>& ref, int w, int h) {
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            blit_cell<SIZE>(fb.pixels.data(), W, x, y, LIFE_HEAT_PALETTE.colour[ref[y * VW + x]]);
+        }
+    }
+}
+
+void check_ages(int w, int h, uint32_t seed) {
+    const int x0 = (W - w) / 2, y0 = (H - h) / 2;
+    auto life = std::make_unique<Grid>();
+    life->clear();
+    seed_soup(*life, W, H, W * H / 4, seed);
+
+    auto ages = std::make_unique<Ages>();
+    ages->clear();
+    ages->sync(w, h, [&](int x, int y) { return life->alive(x0 + x, y0 + y); });
+    std::vector<uint8_t> ref(VW * VH);
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) ref[y * VW + x] = life->alive(x0 + x, y0 + y);
+    }
+    HostFramebuffer shown, want;
+    draw_all(shown, ref, w, h);
+
+    View::Plane planes[2] = {};
+    life->template snapshot_window<VW, VH>(x0, y0, planes[0], w, h);
+    int emitted = 0;
+    for (int g = 0; g < 700; g++) {
+        if (g == 400) {
+            // Cells added between generations, some of them already alive
+            BenchRand r(seed + 1);
+            for (int i = 0; i < 200; i++) life->set(x0 + 1 + r.next() % (w - 2), y0 + 1 + r.next() % (h - 2));
+            ages->sync(w, h, [&](int x, int y) { return life->alive(x0 + x, y0 + y); });
+            for (int y = 0; y < h; y++) {
+                for (int x = 0; x < w; x++) {
+                    uint8_t& a = ref[y * VW + x];
+                    if (life->alive(x0 + x, y0 + y) && !a) a = 1;
+                }
+            }
+            draw_all(shown, ref, w, h);
+            life->template snapshot_window<VW, VH>(x0, y0, planes[g & 1], w, h);
+        }
+        life->step();
+        const View::Plane& prev = planes[g & 1];
+        View::Plane& cur = planes[(g + 1) & 1];
+        life->template snapshot_window<VW, VH>(x0, y0, cur, w, h);
+        ages->update(prev, cur, [&](int x, int y, uint8_t age) {
+            BENCH_CHECK(x < w && y < h, "cell (%d,%d) outside the %dx%d view", x, y, w, h);
+            blit_cell<SIZE>(shown.pixels.data(), W, x, y, LIFE_HEAT_PALETTE.colour[age]);
+            emitted++;
+        }, w, h);
+
+        for (int y = 0; y < h; y++) {
+            for (int x = 0; x < w; x++) {
+                uint8_t& a = ref[y * VW + x];
+                a = !life->alive(x0 + x, y0 + y) ? 0 : a < Ages::MAX_AGE ? a + 1 : a;
+                BENCH_CHECK(ages->age(x, y) == a, "%dx%d gen %d: cell (%d,%d) age %d, expected %d", w, h, g, x, y,
+                            ages->age(x, y), a);
+            }
+        }
+        draw_all(want, ref, w, h);
+        BENCH_CHECK(shown.pixels == want.pixels, "%dx%d gen %d: drawn view differs", w, h, g);
+    }
+    printf("  %3dx%-3d view: %.0f cells redrawn per generation\n", w, h, (double)emitted / 700);
+}
+
+struct Cost {
+    double us;      // Per generation
+    double cells;   // Drawn per generation
+};
+
+// Best of several runs of draw(g, fb, first) over generations [g0, g1)
+template <typename Draw>
+Cost time_frames(int g0, int g1, Draw&& draw) {
+    HostFramebuffer fb;
+    uint64_t best = UINT64_MAX, cells = 0;
+    for (int run = 0; run < 7; run++) {
+        cells = 0;
+        uint64_t t0 = now_us();
+        for (int g = g0; g < g1; g++) cells += draw(g, fb, g == g0);
+        uint64_t us = now_us() - t0;
+        if (us < best) best = us;
+    }
+    return {(double)best / (g1 - g0), (double)cells / (g1 - g0)};
+}
+
+void bench() {
+    constexpr int GENERATIONS = 2000;
+    const int x0 = (W - VW) / 2, y0 = (H - VH) / 2;
+    auto life = std::make_unique<Grid>();
+    life->clear();
+    seed_soup(*life, W, H, W * H / 4, 31);
+    auto planes = std::make_unique<View::Plane[]>(GENERATIONS + 1);
+    for (int g = 0; g <= GENERATIONS; g++) {
+        if (g) life->step();
+        life->template snapshot_window<VW, VH>(x0, y0, planes[g]);
+    }
+
+    auto ages = std::make_unique<Ages>();
+    // Ages as they stand before generation g, for the runs to start from
+    auto ages_at = [&](int g) {
+        ages->clear();
+        ages->sync(VW, VH, [&](int x, int y) { return (planes[0][y][x >> 5] >> (x & 31)) & 1; });
+        for (int i = 1; i < g; i++) ages->update(planes[i - 1], planes[i], [](int, int, uint8_t) {});
+    };
+    std::vector<uint8_t> bytes(VW * VH);
+
+    printf("%dx%d universe, %dx%d view at %dpx; us and cells drawn per generation\n", W, H, VW, VH, SIZE);
+    printf("generations  alive/dying diff      heat map, colour changes   heat map, every live cell\n");
+    const int ranges[2][2] = {{2, 302}, {1000, GENERATIONS + 1}};
+    for (const auto& range : ranges) {
+        int g0 = range[0], g1 = range[1];
+        Cost plain = time_frames(g0, g1, [&](int g, HostFramebuffer& fb, bool) {
+            uint64_t n = 0;
+            View::diff(planes[g - 2], planes[g - 1], planes[g], [&](int x, int y, uint8_t s) {
+                blit_cell<SIZE>(fb.pixels.data(), W, x, y, LIFE_PALETTE[s]);
+                n++;
+            });
+            return n;
+        });
+
+        ages_at(g0);
+        const Ages start = *ages;
+        Cost heat = time_frames(g0, g1, [&](int g, HostFramebuffer& fb, bool first) {
+            if (first) *ages = start;
+            uint64_t n = 0;
+            ages->update(planes[g - 1], planes[g], [&](int x, int y, uint8_t age) {
+                blit_cell<SIZE>(fb.pixels.data(), W, x, y, LIFE_HEAT_PALETTE.colour[age]);
+                n++;
+            });
+            return n;
+        });
+
+        // A byte per cell aged and drawn in full every generation
+        Cost every = time_frames(g0, g1, [&](int g, HostFramebuffer& fb, bool first) {
+            if (first) {
+                for (int y = 0; y < VH; y++) {
+                    for (int x = 0; x < VW; x++) bytes[y * VW + x] = start.age(x, y);
+                }
+            }
+            uint64_t n = 0;
+            for (int y = 0; y < VH; y++) {
+                for (int x = 0; x < VW; x++) {
+                    uint8_t& a = bytes[y * VW + x];
+                    bool alive = (planes[g][y][x >> 5] >> (x & 31)) & 1;
+                    if (!alive && !a) continue;
+                    a = !alive ? 0 : a < Ages::MAX_AGE ? a + 1 : a;
+                    blit_cell<SIZE>(fb.pixels.data(), W, x, y, LIFE_HEAT_PALETTE.colour[a]);
+                    n++;
+                }
+            }
+            return n;
+        });
+
+        printf("%4d-%-4d    %7.2f us %6.0f      %7.2f us %6.0f (%+5.1f us)   %7.2f us %6.0f\n", g0, g1 - 1,
+               plain.us, plain.cells, heat.us, heat.cells, heat.us - plain.us, every.us, every.cells);
+    }
+}
+
+int main() {
+    check_palette();
+    check_ages(VW, VH, 41);
+    check_ages(40, 30, 42);
+    printf("Heat map ages and redraws match a byte-per-cell reference\n");
+    bench();
+    return 0;
+}
@@ -0,0 +1,42 @@
+/**
+ * PNG decoding for the host benchmarks
+ *
+ * libpng stands in for PNGdec: decode_png() leaves a 320x240 PNG in a
+ * HostFramebuffer as big-endian RGB565, truncated the way
+ * png_draw_callback() converts each row with getLineAsRGB565().
+ */
+
+#pragma once
+
+#include <string.h>
+#include <png.h>
+#include <vector>
+#include "bench.hpp"
+#include "life_render.hpp"
+
+// False unless data is a PNG of exactly the framebuffer's size. rgb is
+// scratch space for the decoded rows, kept by the caller across calls.
+inline bool decode_png(const uint8_t* data, size_t size, HostFramebuffer& fb, std::vector<uint8_t>& rgb) {
+    constexpr int W = HostFramebuffer::WIDTH, H = HostFramebuffer::HEIGHT;
+    png_image image;
+    memset(&image, 0, sizeof(image));
+    image.version = PNG_IMAGE_VERSION;
+    if (!png_image_begin_read_from_memory(&image, data, size)) return false;
+    image.format = PNG_FORMAT_RGB;
+    if (image.width != W || image.height != H) {
+        png_image_free(&image);
+        return false;
+    }
+    rgb.resize(PNG_IMAGE_SIZE(image));
+    if (!png_image_finish_read(&image, nullptr, rgb.data(), 0, nullptr)) return false;
+    for (int y = 0; y < H; y++) {
+        const uint8_t* row = &rgb[y * W * 3];
+        uint16_t* out = &fb.pixels[y * W];
+        for (int x = 0; x < W; x++) out[x] = rgb565_be(row[x * 3], row[x * 3 + 1], row[x * 3 + 2]);
+    }
+    return true;
+}
+
+inline bool decode_png(const std::vector<uint8_t>& file, HostFramebuffer& fb, std::vector<uint8_t>& rgb) {
+    return decode_png(file.data(), file.size(), fb, rgb);
+}
@@ -0,0 +1,113 @@
+/**
+ * Pre-decoded .565 images vs PNG
+ *
+ * For each image in test_images/, decodes the PNG into the framebuffer
+ * the way png_draw_callback() does (libpng stands in for PNGdec on the
+ * host), encodes the result as a .565 file and checks that loading that
+ * gives the same framebuffer. Then reports the latency from file bytes
+ * in memory to pixels in the framebuffer for both, and the bytes each
+ * one has to read from flash.
+ *
+ *     image_bench [file.565 ...]
+ *
+ * also checks .565 files written by build_filesystem.py --raw565 against
+ * the PNG of the same name.
+ */
+
+#include <string.h>
+#include <string>
+#include <vector>
+#include "bench.hpp"
+#include "host_png.hpp"
+#include "image565.hpp"
+
+#ifndef TEST_IMAGE_DIR
+#define TEST_IMAGE_DIR "test_images"
+#endif
+
+constexpr int W = HostFramebuffer::WIDTH;
+constexpr int H = HostFramebuffer::HEIGHT;
+
+const char* const IMAGES[] = {"tufty-name", "tufty1", "tufty2", "tufty3", "tufty4", "tufty5"};
+
+std::vector<uint8_t> read_file(const std::string& path) {
+    FILE* f = fopen(path.c_str(), "rb");
+    BENCH_CHECK(f, "cannot open %s", path.c_str());
+    std::vector<uint8_t> data;
+    uint8_t buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) data.insert(data.end(), buf, buf + n);
+    fclose(f);
+    return data;
+}
+
+std::vector<uint8_t> encode_565(const HostFramebuffer& fb) {
+    const uint8_t header[IMAGE565_HEADER] = {'R', '5', '6', '5', W & 0xFF, W >> 8, H & 0xFF, H >> 8};
+    std::vector<uint8_t> file(IMAGE565_HEADER + W * H * 2);
+    memcpy(file.data(), header, IMAGE565_HEADER);
+    memcpy(file.data() + IMAGE565_HEADER, fb.pixels.data(), W * H * 2);
+    return file;
+}
+
+// As load_raw565(): check the header, then one copy into the framebuffer
+bool load_565(const std::vector<uint8_t>& file, HostFramebuffer& fb) {
+    Image565Info info;
+    if (file.size() < IMAGE565_HEADER || !image565_header(file.data(), info)) return false;
+    if (info.width != W || info.height != H || file.size() < IMAGE565_HEADER + info.bytes()) return false;
+    memcpy(fb.pixels.data(), file.data() + IMAGE565_HEADER, info.bytes());
+    return true;
+}
+
+// Best of several runs, in microseconds
+template <typename Fn>
+double best_us(Fn&& fn) {
+    double best = 1e30;
+    for (int run = 0; run < 15; run++) {
+        uint64_t t0 = now_us();
+        fn();
+        double us = (double)(now_us() - t0);
+        if (us < best) best = us;
+    }
+    return best;
+}
+
+// A .565 written by build_filesystem.py must match the PNG it came from
+void check_converted(const char* path) {
+    std::string name = path;
+    size_t slash = name.find_last_of('/');
+    std::string stem = name.substr(slash == std::string::npos ? 0 : slash + 1);
+    stem = stem.substr(0, stem.size() - 4);
+    HostFramebuffer want, got;
+    std::vector<uint8_t> rgb;
+    BENCH_CHECK(decode_png(read_file(std::string(TEST_IMAGE_DIR) + "/" + stem + ".png"), want, rgb),
+                "%s.png did not decode", stem.c_str());
+    BENCH_CHECK(load_565(read_file(path), got), "%s is not a full-screen .565", path);
+    BENCH_CHECK(got.pixels == want.pixels, "%s differs from %s.png", path, stem.c_str());
+    printf("  %s matches %s.png\n", path, stem.c_str());
+}
+
+int main(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) check_converted(argv[i]);
+
+    printf("image          png bytes  565 bytes   png decode   565 load   speedup\n");
+    double total_png = 0, total_raw = 0;
+    for (const char* name : IMAGES) {
+        std::vector<uint8_t> png = read_file(std::string(TEST_IMAGE_DIR) + "/" + name + ".png");
+        HostFramebuffer decoded, loaded;
+        std::vector<uint8_t> rgb;
+        BENCH_CHECK(decode_png(png, decoded, rgb), "%s.png did not decode to %dx%d", name, W, H);
+        std::vector<uint8_t> raw = encode_565(decoded);
+        BENCH_CHECK(load_565(raw, loaded), "%s.565 did not load", name);
+        BENCH_CHECK(loaded.pixels == decoded.pixels, "%s: .565 framebuffer differs from the PNG's", name);
+
+        double png_us = best_us([&] { decode_png(png, decoded, rgb); });
+        double raw_us = best_us([&] { load_565(raw, loaded); });
+        total_png += png_us;
+        total_raw += raw_us;
+        printf("%-12s %10zu %10zu %9.0f us %7.1f us %8.0fx\n", name, png.size(), raw.size(), png_us, raw_us,
+               png_us / raw_us);
+    }
+    printf("total                               %9.0f us %7.1f us %8.0fx\n", total_png, total_raw,
+           total_png / total_raw);
+    return 0;
+}
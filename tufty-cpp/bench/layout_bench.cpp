@@ -0,0 +1,87 @@
+/**
+ * Row-major vs column-major Life storage
+ *
+ * Times the generation stage on its own and the generation + draw stage
+ * (changed cells written as LIFE_SIZE squares into a host RGB565
+ * framebuffer), plus a full-grid redraw in storage order. Both layouts
+ * must produce the same framebuffer.
+ */
+
+#include <memory>
+#include "bench.hpp"
+#include "life.hpp"
+
+constexpr int LIFE_SIZE = 3;
+
+template <int W, int H, LifeLayout L>
+struct Stages {
+    uint64_t gen_us;
+    uint64_t draw_us;
+    uint64_t full_us;
+    std::vector<uint16_t> pixels;
+};
+
+template <int W, int H, LifeLayout L>
+Stages<W, H, L> run(int generations) {
+    Stages<W, H, L> r = {0, 0, 0, {}};
+    HostFramebuffer fb;
+    auto life = std::make_unique<BitLife<W, H, L>>();
+
+    life->clear();
+    life->set_skip_stable(false);
+    seed_soup(*life, W, H, W * H / 4, 31);
+    uint64_t t0 = now_us();
+    for (int g = 0; g < generations; g++) life->step();
+    r.gen_us = now_us() - t0;
+
+    life->clear();
+    life->set_skip_stable(false);
+    seed_soup(*life, W, H, W * H / 4, 31);
+    t0 = now_us();
+    for (int g = 0; g < generations; g++) {
+        life->step([&](int x, int y, uint8_t state) {
+            fb.rectangle(x * LIFE_SIZE, y * LIFE_SIZE, LIFE_SIZE, LIFE_SIZE, HostFramebuffer::state_colour(state));
+        });
+    }
+    r.draw_us = now_us() - t0;
+    r.pixels = fb.pixels;
+
+    // Full redraw, walking cells in the order they are stored
+    t0 = now_us();
+    for (int g = 0; g < generations; g++) {
+        constexpr int OUTER = L == LifeLayout::RowMajor ? H : W;
+        constexpr int INNER = L == LifeLayout::RowMajor ? W : H;
+        for (int o = 0; o < OUTER; o++) {
+            for (int i = 0; i < INNER; i++) {
+                int x = L == LifeLayout::RowMajor ? i : o;
+                int y = L == LifeLayout::RowMajor ? o : i;
+                fb.rectangle(x * LIFE_SIZE, y * LIFE_SIZE, LIFE_SIZE, LIFE_SIZE,
+                             HostFramebuffer::state_colour(life->state(x, y)));
+            }
+        }
+    }
+    r.full_us = now_us() - t0;
+    return r;
+}
+
+template <int W, int H>
+void compare(int generations) {
+    auto row = run<W, H, LifeLayout::RowMajor>(generations);
+    auto col = run<W, H, LifeLayout::ColumnMajor>(generations);
+    BENCH_CHECK(row.pixels == col.pixels, "%dx%d layouts drew different frames", W, H);
+
+    double cells = (double)W * H * generations;
+    printf("%dx%d, %d generations\n", W, H, generations);
+    printf("  generation    row: %8.1f Mcells/s   column: %8.1f Mcells/s\n",
+           cells / row.gen_us, cells / col.gen_us);
+    printf("  gen + draw    row: %8.1f Mcells/s   column: %8.1f Mcells/s\n",
+           cells / row.draw_us, cells / col.draw_us);
+    printf("  full redraw   row: %8.1f Mcells/s   column: %8.1f Mcells/s\n",
+           cells / row.full_us, cells / col.full_us);
+}
+
+int main() {
+    compare<106, 80>(2000);
+    compare<320, 240>(200);
+    return 0;
+}
@@ -0,0 +1,68 @@
+/**
+ * Bit-sliced Life kernel vs the original byte-per-cell kernel
+ *
+ * Checks that BitLife produces the same alive/dying/dead states as the
+ * reference for a few hundred generations, then reports cells/second for
+ * both at the badge's 106x80 and at larger sizes.
+ */
+
+#include <memory>
+#include "bench.hpp"
+#include "life.hpp"
+
+template <int W, int H>
+void check_against_reference(int generations) {
+    ReferenceLife ref(W, H);
+    auto life = std::make_unique<BitLife<W, H>>();
+    life->clear();
+    int dots = W * H / 4;
+    seed_soup(ref, W, H, dots, 1234);
+    seed_soup(*life, W, H, dots, 1234);
+
+    for (int g = 0; g < generations; g++) {
+        ref.step();
+        life->step();
+        for (int x = 0; x < W; x++) {
+            for (int y = 0; y < H; y++) {
+                BENCH_CHECK(ref.state(x, y) == life->state(x, y),
+                            "%dx%d gen %d cell (%d,%d): ref=%d bit=%d",
+                            W, H, g, x, y, ref.state(x, y), life->state(x, y));
+            }
+        }
+    }
+}
+
+template <int W, int H>
+void bench_size(int generations) {
+    double cells = (double)W * H * generations;
+
+    ReferenceLife ref(W, H);
+    seed_soup(ref, W, H, W * H / 4, 42);
+    uint64_t t0 = now_us();
+    for (int g = 0; g < generations; g++) ref.step();
+    uint64_t ref_us = now_us() - t0;
+
+    auto life = std::make_unique<BitLife<W, H>>();
+    life->clear();
+    seed_soup(*life, W, H, W * H / 4, 42);
+    t0 = now_us();
+    for (int g = 0; g < generations; g++) life->step();
+    uint64_t bit_us = now_us() - t0;
+
+    printf("%5dx%-5d %6d gens  byte: %8.1f Mcells/s  bit: %8.1f Mcells/s  x%.1f\n",
+           W, H, generations,
+           cells / (double)(ref_us ? ref_us : 1),
+           cells / (double)(bit_us ? bit_us : 1),
+           (double)ref_us / (double)(bit_us ? bit_us : 1));
+}
+
+int main() {
+    check_against_reference<106, 80>(300);
+    check_against_reference<67, 45>(200);
+    printf("BitLife matches reference kernel\n");
+
+    bench_size<106, 80>(5000);
+    bench_size<256, 256>(500);
+    bench_size<1024, 1024>(30);
+    return 0;
+}
@@ -0,0 +1,72 @@
+/**
+ * Lookup-table kernel vs the bit-sliced and original kernels
+ *
+ * Checks the LUT-backed BitLife against the reference byte kernel, then
+ * reports cells/second for all three and the table's storage cost.
+ */
+
+#include <memory>
+#include "bench.hpp"
+#include "life.hpp"
+#include "life_lut.hpp"
+
+template <int W, int H>
+using LutLife = BitLife<W, H, LifeLayout::RowMajor, LutKernel<>>;
+
+template <int W, int H>
+void check(int generations) {
+    ReferenceLife ref(W, H);
+    auto life = std::make_unique<LutLife<W, H>>();
+    life->clear();
+    seed_soup(ref, W, H, W * H / 4, 17);
+    seed_soup(*life, W, H, W * H / 4, 17);
+    for (int g = 0; g < generations; g++) {
+        ref.step();
+        life->step();
+        for (int y = 0; y < H; y++) {
+            for (int x = 0; x < W; x++) {
+                BENCH_CHECK(ref.state(x, y) == life->state(x, y), "%dx%d gen %d cell (%d,%d)", W, H, g, x, y);
+            }
+        }
+    }
+}
+
+template <typename Grid>
+uint64_t time_grid(int generations) {
+    auto life = std::make_unique<Grid>();
+    life->clear();
+    life->set_skip_stable(false);
+    seed_soup(*life, Grid::WIDTH, Grid::HEIGHT, Grid::WIDTH * Grid::HEIGHT / 4, 5);
+    uint64_t t0 = now_us();
+    for (int g = 0; g < generations; g++) life->step();
+    return now_us() - t0;
+}
+
+template <int W, int H>
+void bench(int generations) {
+    ReferenceLife ref(W, H);
+    seed_soup(ref, W, H, W * H / 4, 5);
+    uint64_t t0 = now_us();
+    for (int g = 0; g < generations; g++) ref.step();
+    uint64_t ref_us = now_us() - t0;
+
+    uint64_t swar_us = time_grid<BitLife<W, H>>(generations);
+    uint64_t lut_us = time_grid<LutLife<W, H>>(generations);
+
+    double cells = (double)W * H * generations;
+    printf("%5dx%-5d  byte %8.1f   swar %8.1f   lut %8.1f  Mcells/s\n", W, H,
+           cells / ref_us, cells / swar_us, cells / lut_us);
+}
+
+int main() {
+    check<106, 80>(300);
+    check<67, 45>(200);
+    printf("LUT kernel matches reference kernel\n");
+    printf("Table: %zu bytes of flash (%d entries, 4 bits each), 0 bytes of RAM\n",
+           sizeof(LifeLut<>), LifeLut<>::KEYS);
+
+    bench<106, 80>(3000);
+    bench<256, 256>(300);
+    bench<1024, 1024>(20);
+    return 0;
+}
@@ -0,0 +1,168 @@
+/**
+ * Frame pacing for Game of Life
+ *
+ * Drives FramePacer with a fake microsecond clock, charging each frame
+ * a cost per generation and a cost for the display update, and checks
+ * the frames it schedules: as many generations as fit in the frame
+ * period up to the cap, one when the display or a generation alone takes
+ * longer, the target frame rate whenever the work fits, quick recovery
+ * when the costs change, and no burst of frames to catch up after a
+ * stall. Reports the generations per second and displayed frames per
+ * second achieved in each case.
+ */
+
+#include <algorithm>
+#include <vector>
+#include "bench.hpp"
+#include "frame_pacer.hpp"
+
+constexpr uint32_t FPS = 30;
+constexpr int MAX_GENERATIONS = 8;
+
+struct FakeClock {
+    uint64_t now = 1000000;
+};
+
+// What a generation and a display update cost in frame f
+struct Costs {
+    uint32_t generation, update;
+};
+
+struct Frame {
+    uint64_t start;
+    int generations;
+};
+
+// Run `frames` frames, asking costs(f) what frame f costs
+template <typename CostsOf>
+std::vector<Frame> run(FramePacer& pacer, int frames, CostsOf&& costs) {
+    FakeClock clock;
+    pacer.reset(clock.now);
+    std::vector<Frame> out;
+    for (int f = 0; f < frames; f++) {
+        Costs c = costs(f);
+        Frame frame{clock.now, pacer.begin_frame(clock.now)};
+        BENCH_CHECK(frame.generations >= 1 && frame.generations <= MAX_GENERATIONS, "frame %d: %d generations", f,
+                    frame.generations);
+        clock.now += (uint64_t)frame.generations * c.generation;
+        pacer.computed(clock.now, frame.generations);
+        clock.now += c.update;
+        clock.now += pacer.end_frame(clock.now);
+        out.push_back(frame);
+    }
+    // The end of the last frame, for the rates
+    out.push_back({clock.now, 0});
+    return out;
+}
+
+struct Rates {
+    double fps, generations_per_second, generations_per_frame;
+};
+
+// Rates over frames [f0, f1)
+Rates rates(const std::vector<Frame>& frames, int f0, int f1) {
+    uint64_t generations = 0;
+    for (int f = f0; f < f1; f++) generations += frames[f].generations;
+    double seconds = (double)(frames[f1].start - frames[f0].start) / 1e6;
+    return {(f1 - f0) / seconds, generations / seconds, (double)generations / (f1 - f0)};
+}
+
+void check_steady() {
+    const uint32_t period = 1000000 / FPS;
+    const Costs cases[] = {
+        {0, 6000},        // Generations too quick to measure
+        {150, 6000},      // A settled board at small zoom
+        {4000, 12000},    // Balanced
+        {9000, 20000},    // Room for one generation only
+        {3000, 45000},    // The display is the bottleneck
+        {40000, 5000},    // A generation alone overruns the frame
+    };
+    printf("Steady costs, %u fps target, up to %d generations per frame\n", FPS, MAX_GENERATIONS);
+    printf("generation   update   gens/frame      fps   gens/s\n");
+    for (const Costs& c : cases) {
+        FramePacer pacer(FPS, MAX_GENERATIONS);
+        auto frames = run(pacer, 300, [&](int) { return c; });
+
+        uint32_t budget = period > c.update ? period - c.update : 0;
+        int want = std::clamp<int>(budget / std::max<uint32_t>(c.generation, 1), 1, MAX_GENERATIONS);
+        uint64_t frame_us = std::max<uint64_t>(period, (uint64_t)want * c.generation + c.update);
+        for (int f = 20; f < 300; f++) {
+            BENCH_CHECK(frames[f].generations == want, "%u/%u us: frame %d has %d generations, expected %d",
+                        c.generation, c.update, f, frames[f].generations, want);
+        }
+        Rates r = rates(frames, 20, 300);
+        double want_fps = 1e6 / frame_us;
+        BENCH_CHECK(r.fps > want_fps * 0.995 && r.fps < want_fps * 1.005, "%u/%u us: %.2f fps, expected %.2f",
+                    c.generation, c.update, r.fps, want_fps);
+        printf("%7u us %6u us %12.2f %8.2f %8.1f\n", c.generation, c.update, r.generations_per_frame, r.fps,
+               r.generations_per_second);
+    }
+}
+
+// Costs vary by up to a quarter either way from frame to frame
+void check_jitter() {
+    printf("Jittery costs (+-25%%)\n");
+    const Costs cases[] = {{150, 6000}, {4000, 12000}, {3000, 45000}};
+    for (const Costs& c : cases) {
+        FramePacer pacer(FPS, MAX_GENERATIONS);
+        BenchRand r(c.generation);
+        auto jitter = [&](uint32_t us) { return us * (750 + r.next() % 501) / 1000; };
+        auto frames = run(pacer, 600, [&](int) { return Costs{jitter(c.generation), jitter(c.update)}; });
+
+        int lo = MAX_GENERATIONS, hi = 1;
+        for (int f = 20; f < 600; f++) {
+            lo = std::min(lo, frames[f].generations);
+            hi = std::max(hi, frames[f].generations);
+        }
+        Rates rt = rates(frames, 20, 600);
+        // The averages smooth the noise: the plan wobbles by a generation
+        // either side of the ideal at most
+        BENCH_CHECK(hi - lo <= 2, "%u/%u us: %d to %d generations per frame", c.generation, c.update, lo, hi);
+        double ideal = 1e6 / std::max<double>(1e6 / FPS, c.update + (double)lo * c.generation);
+        BENCH_CHECK(rt.fps > ideal * 0.95, "%u/%u us: %.2f fps, expected about %.2f", c.generation, c.update, rt.fps,
+                    ideal);
+        printf("%7u us %6u us %7d-%-4d %8.2f %8.1f\n", c.generation, c.update, lo, hi, rt.fps,
+               rt.generations_per_second);
+    }
+}
+
+// The display update gets cheap (zooming out of big cells), then dear again
+void check_adapt() {
+    FramePacer pacer(FPS, MAX_GENERATIONS);
+    auto frames = run(pacer, 300, [](int f) { return Costs{150, f >= 100 && f < 200 ? 6000u : 45000u}; });
+    int up = 100, down = 200;
+    while (frames[up].generations != MAX_GENERATIONS) up++;
+    while (frames[down].generations != 1) down++;
+    BENCH_CHECK(up - 100 <= 10, "%d frames to speed up", up - 100);
+    BENCH_CHECK(down - 200 <= 20, "%d frames to slow down", down - 200);
+    for (int f = up; f < 200; f++) BENCH_CHECK(frames[f].generations == MAX_GENERATIONS, "frame %d", f);
+    for (int f = down; f < 300; f++) BENCH_CHECK(frames[f].generations == 1, "frame %d", f);
+    printf("Update 45 ms -> 6 ms: %d frames to reach %d generations; back to 45 ms: %d frames to drop to 1\n",
+           up - 100, MAX_GENERATIONS, down - 200);
+}
+
+// One frame stalls for half a second (a full redraw after a key press)
+void check_stall() {
+    const uint32_t period = 1000000 / FPS;
+    FramePacer pacer(FPS, MAX_GENERATIONS);
+    auto frames = run(pacer, 200, [](int f) { return Costs{150, f == 100 ? 500000u : 6000u}; });
+    // Frames never come closer together than the period: no catching up
+    for (int f = 1; f < 200; f++) {
+        uint64_t gap = frames[f].start - frames[f - 1].start;
+        BENCH_CHECK(gap >= period, "frames %d and %d %llu us apart", f - 1, f, (unsigned long long)gap);
+    }
+    int back = 101;
+    while (frames[back].generations != MAX_GENERATIONS) back++;
+    BENCH_CHECK(back - 101 <= 30, "%d frames to recover from the stall", back - 101);
+    Rates r = rates(frames, back, 200);
+    BENCH_CHECK(r.fps > FPS * 0.995, "%.2f fps after the stall", r.fps);
+    printf("500 ms stall: no catch-up burst, %d frames back to %d generations\n", back - 101, MAX_GENERATIONS);
+}
+
+int main() {
+    check_steady();
+    check_jitter();
+    check_adapt();
+    check_stall();
+    return 0;
+}
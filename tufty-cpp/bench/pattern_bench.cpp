@@ -0,0 +1,262 @@
+/**
+ * Streaming RLE / plaintext pattern parser
+ *
+ * Parses the files in test_patterns/ through the same 256-byte buffered
+ * loader as the firmware and checks sizes, cell counts, rules and
+ * centring, and that results do not depend on how the input is chunked.
+ * Checks that Generations rules in headers are not taken for B/S rules.
+ * Then times the parser on multi-megabyte generated soups.
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "bench.hpp"
+#include "life.hpp"
+#include "life_pattern.hpp"
+
+#ifndef TEST_PATTERN_DIR
+#define TEST_PATTERN_DIR "test_patterns"
+#endif
+
+// A file read through stdio, as the firmware reads LittleFS
+struct StdioSource {
+    FILE* f;
+
+    int read(char* buf, int len) { return (int)fread(buf, 1, len, f); }
+    void rewind() { fseek(f, 0, SEEK_SET); }
+};
+
+// An in-memory file
+struct MemorySource {
+    const std::string& data;
+    size_t pos = 0;
+
+    int read(char* buf, int len) {
+        size_t n = data.size() - pos < (size_t)len ? data.size() - pos : (size_t)len;
+        memcpy(buf, data.data() + pos, n);
+        pos += n;
+        return (int)n;
+    }
+    void rewind() { pos = 0; }
+};
+
+std::string read_file(const std::string& path) {
+    std::string out;
+    FILE* f = fopen(path.c_str(), "rb");
+    BENCH_CHECK(f, "cannot open %s", path.c_str());
+    char buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) out.append(buf, n);
+    fclose(f);
+    return out;
+}
+
+struct Expected {
+    const char* name;
+    int width, height;
+    uint32_t cells;
+    uint16_t birth, survive;   // 0, 0 if the file has no rule
+};
+
+const Expected PATTERNS[] = {
+    {"glider.rle", 3, 3, 5, 1 << 3, (1 << 2) | (1 << 3)},
+    {"gosper_glider_gun.rle", 36, 9, 36, 1 << 3, (1 << 2) | (1 << 3)},
+    {"replicator.rle", 5, 5, 12, (1 << 3) | (1 << 6), (1 << 2) | (1 << 3)},
+    {"r_pentomino.cells", 3, 3, 5, 0, 0},
+    {"acorn.cells", 7, 3, 7, 0, 0},
+};
+
+void check_files() {
+    using Grid = BitLife<106, 80>;
+    for (const Expected& e : PATTERNS) {
+        std::string path = std::string(TEST_PATTERN_DIR) + "/" + e.name;
+        FILE* f = fopen(path.c_str(), "rb");
+        BENCH_CHECK(f, "cannot open %s", path.c_str());
+        StdioSource source{f};
+        auto grid = std::make_unique<Grid>();
+        grid->clear();
+        LifePatternFormat format = life_pattern_format(e.name);
+        LifePatternParser parser(format);
+        uint32_t placed = load_life_pattern(*grid, parser, format, source, 53, 40);
+        fclose(f);
+
+        BENCH_CHECK(parser.width() == e.width && parser.height() == e.height, "%s: %dx%d, expected %dx%d", e.name,
+                    parser.width(), parser.height(), e.width, e.height);
+        BENCH_CHECK(placed == e.cells && parser.cells() == e.cells, "%s: %u cells, expected %u", e.name, placed,
+                    e.cells);
+        BENCH_CHECK(parser.has_rule() == (e.birth != 0), "%s: rule %s", e.name, parser.has_rule() ? "found" : "missing");
+        BENCH_CHECK(parser.birth() == e.birth && parser.survive() == e.survive, "%s: rule B%x/S%x", e.name,
+                    parser.birth(), parser.survive());
+
+        // Centred: the bounding box of the placed cells straddles (53, 40)
+        int x0 = 106, y0 = 80, x1 = -1, y1 = -1;
+        for (int y = 0; y < 80; y++) {
+            for (int x = 0; x < 106; x++) {
+                if (!grid->alive(x, y)) continue;
+                x0 = x < x0 ? x : x0;
+                y0 = y < y0 ? y : y0;
+                x1 = x > x1 ? x : x1;
+                y1 = y > y1 ? y : y1;
+            }
+        }
+        BENCH_CHECK(x0 == 53 - e.width / 2 && y0 == 40 - e.height / 2 && x1 == x0 + e.width - 1 &&
+                    y1 == y0 + e.height - 1, "%s: placed at (%d,%d)-(%d,%d)", e.name, x0, y0, x1, y1);
+    }
+
+    // The glider, cell by cell
+    auto grid = std::make_unique<Grid>();
+    grid->clear();
+    std::string glider = read_file(std::string(TEST_PATTERN_DIR) + "/glider.rle");
+    MemorySource source{glider};
+    LifePatternParser parser(LifePatternFormat::Rle);
+    load_life_pattern(*grid, parser, LifePatternFormat::Rle, source, 53, 40);
+    const int cells[5][2] = {{1, 0}, {2, 1}, {0, 2}, {1, 2}, {2, 2}};
+    for (const auto& c : cells) {
+        BENCH_CHECK(grid->alive(52 + c[0], 39 + c[1]), "glider cell (%d,%d) missing", c[0], c[1]);
+    }
+}
+
+// Rules in RLE headers: B/S rules in either order are taken, Generations
+// rules with more than two states are not
+void check_rules() {
+    struct Case {
+        const char* rule;
+        bool taken;
+        uint16_t birth, survive;
+        int states;
+    };
+    const Case cases[] = {
+        {"B3/S23", true, 1 << 3, (1 << 2) | (1 << 3), 2},
+        {"23/36", true, (1 << 3) | (1 << 6), (1 << 2) | (1 << 3), 2},
+        {"B2/S", true, 1 << 2, 0, 2},
+        {"B3/S23/2", true, 1 << 3, (1 << 2) | (1 << 3), 2},
+        {"B2/S/3", false, 1 << 2, 0, 3},
+        {"B2/S/C3", false, 1 << 2, 0, 3},
+        {"/2/3", false, 1 << 2, 0, 3},
+        {"345/2/4", false, 1 << 2, (1 << 3) | (1 << 4) | (1 << 5), 4},
+    };
+    for (const Case& c : cases) {
+        std::string data = std::string("x = 3, y = 1, rule = ") + c.rule + "\n3o!\n";
+        LifePatternParser parser(LifePatternFormat::Rle);
+        parser.feed(data.data(), data.size(), [](int, int) {});
+        BENCH_CHECK(parser.has_rule() == c.taken, "%s: rule %s", c.rule, parser.has_rule() ? "taken" : "rejected");
+        BENCH_CHECK(parser.birth() == c.birth && parser.survive() == c.survive && parser.states() == c.states,
+                    "%s: B%x/S%x/%d", c.rule, parser.birth(), parser.survive(), parser.states());
+        BENCH_CHECK(parser.cells() == 3, "%s: %u cells", c.rule, parser.cells());
+    }
+}
+
+// Every chunk size gives the same cells
+void check_chunking(const std::string& data, LifePatternFormat format) {
+    std::vector<std::pair<int, int>> whole, pieces;
+    LifePatternParser parser(format);
+    parser.feed(data.data(), data.size(), [&](int x, int y) { whole.push_back({x, y}); });
+    for (size_t chunk : {1, 7, 256}) {
+        pieces.clear();
+        parser.reset(format);
+        for (size_t i = 0; i < data.size(); i += chunk) {
+            size_t n = data.size() - i < chunk ? data.size() - i : chunk;
+            parser.feed(data.data() + i, n, [&](int x, int y) { pieces.push_back({x, y}); });
+        }
+        BENCH_CHECK(pieces == whole, "chunk size %zu gives %zu cells, whole gives %zu", chunk, pieces.size(),
+                    whole.size());
+    }
+}
+
+// A W x H soup with about a third of the cells alive, as RLE wrapped at 70
+// columns like Golly writes it, or as plaintext
+std::string make_soup(int w, int h, bool rle, std::vector<uint8_t>& cells) {
+    BenchRand r(12);
+    cells.assign((size_t)w * h, 0);
+    for (auto& c : cells) c = r.next() % 3 == 0;
+
+    std::string out;
+    if (!rle) {
+        out += "!Name: soup\n";
+        for (int y = 0; y < h; y++) {
+            for (int x = 0; x < w; x++) out += cells[(size_t)y * w + x] ? 'O' : '.';
+            out += '\n';
+        }
+        return out;
+    }
+
+    out += "#N soup\nx = " + std::to_string(w) + ", y = " + std::to_string(h) + ", rule = B3/S23\n";
+    size_t column = 0;
+    auto put = [&](int n, char tag) {
+        std::string item = (n > 1 ? std::to_string(n) : "") + tag;
+        if (column + item.size() > 70) {
+            out += '\n';
+            column = 0;
+        }
+        out += item;
+        column += item.size();
+    };
+    for (int y = 0; y < h; y++) {
+        int x = 0;
+        while (x < w) {
+            uint8_t v = cells[(size_t)y * w + x];
+            int n = 1;
+            while (x + n < w && cells[(size_t)y * w + x + n] == v) n++;
+            if (v || x + n < w) put(n, v ? 'o' : 'b');
+            x += n;
+        }
+        put(1, y + 1 < h ? '$' : '!');
+    }
+    out += '\n';
+    return out;
+}
+
+void bench(int w, int h, bool rle) {
+    std::vector<uint8_t> cells;
+    std::string data = make_soup(w, h, rle, cells);
+    LifePatternFormat format = rle ? LifePatternFormat::Rle : LifePatternFormat::Plaintext;
+    uint32_t expected = 0;
+    for (uint8_t c : cells) expected += c;
+
+    // Parse alone, 256 bytes at a time as from the filesystem
+    LifePatternParser parser(format);
+    uint64_t sum = 0, want = 0;
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            if (cells[(size_t)y * w + x]) want += (uint64_t)y * w + x;
+        }
+    }
+    uint64_t t0 = now_us();
+    for (size_t i = 0; i < data.size(); i += 256) {
+        size_t n = data.size() - i < 256 ? data.size() - i : 256;
+        parser.feed(data.data() + i, n, [&](int x, int y) { sum += (uint64_t)y * w + x; });
+    }
+    uint64_t parse_us = now_us() - t0;
+    BENCH_CHECK(parser.cells() == expected && sum == want, "%dx%d soup: %u cells, expected %u", w, h, parser.cells(),
+                expected);
+
+    // And into a grid through the loader
+    auto grid = std::make_unique<BitLife<4096, 4096>>();
+    grid->clear();
+    MemorySource source{data};
+    t0 = now_us();
+    uint32_t placed = load_life_pattern(*grid, parser, format, source, 2048, 2048);
+    uint64_t load_us = now_us() - t0;
+    BENCH_CHECK(placed == expected, "%dx%d soup: placed %u of %u", w, h, placed, expected);
+
+    printf("%-9s %4dx%-4d %6.2f MB  parse %6.1f Mcells/s %6.1f MB/s   load %6.1f Mcells/s\n", rle ? "RLE" : "plaintext",
+           w, h, data.size() / 1e6, (double)w * h / parse_us, data.size() / (double)parse_us,
+           (double)w * h / load_us);
+}
+
+int main() {
+    check_files();
+    check_rules();
+    check_chunking(read_file(std::string(TEST_PATTERN_DIR) + "/gosper_glider_gun.rle"), LifePatternFormat::Rle);
+    check_chunking(read_file(std::string(TEST_PATTERN_DIR) + "/acorn.cells"), LifePatternFormat::Plaintext);
+    std::vector<uint8_t> cells;
+    check_chunking(make_soup(300, 200, true, cells), LifePatternFormat::Rle);
+    printf("Test patterns parse as expected, independent of chunking\n");
+
+    bench(1024, 1024, true);
+    bench(4094, 4094, true);
+    bench(1024, 1024, false);
+    bench(2048, 2048, false);
+    return 0;
+}
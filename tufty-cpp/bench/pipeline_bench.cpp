@@ -0,0 +1,153 @@
+/**
+ * Two-stage Life pipeline on host threads
+ *
+ * First checks that the pipelined frames are identical to the serial
+ * fused path frame by frame: the worker is free-running, so this holds
+ * regardless of thread timing, also when restarted on a board drawn with
+ * dying cells. Then compares frames/second for serial and
+ * pipelined runs with a sleep standing in for the display transfer.
+ */
+
+#include <memory>
+#include <thread>
+#include "bench.hpp"
+#include "life.hpp"
+#include "life_render.hpp"
+#include "life_pipeline.hpp"
+
+constexpr int LIFE_X = 106;
+constexpr int LIFE_Y = 80;
+constexpr int LIFE_SIZE = 3;
+constexpr int LIFE_FRAMES = 500;
+
+// The display transfer is DMA-driven, so model it as a wait that leaves
+// the CPU free rather than as a busy loop
+void display_transfer(uint64_t us) {
+    std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+void check_identical() {
+    using Grid = BitLife<LIFE_X, LIFE_Y>;
+    Grid serial, piped;
+    HostFramebuffer fb_serial, fb_piped;
+    serial.clear();
+    piped.clear();
+    seed_soup(serial, LIFE_X, LIFE_Y, 2000, 8);
+    seed_soup(piped, LIFE_X, LIFE_Y, 2000, 8);
+
+    LifePipeline<Grid> pipeline(piped);
+    pipeline.start();
+    for (int f = 0; f < LIFE_FRAMES; f++) {
+        serial.step([&](int x, int y, uint8_t state) {
+            blit_cell<LIFE_SIZE>(fb_serial.pixels.data(), HostFramebuffer::WIDTH, x, y, LIFE_PALETTE[state]);
+        });
+        pipeline.next([&](int x, int y, uint8_t state) {
+            blit_cell<LIFE_SIZE>(fb_piped.pixels.data(), HostFramebuffer::WIDTH, x, y, LIFE_PALETTE[state]);
+        });
+        BENCH_CHECK(fb_serial.pixels == fb_piped.pixels, "frame %d differs", f);
+        BENCH_CHECK(serial.active_tiles() == pipeline.active_tiles(), "frame %d tile count differs", f);
+    }
+    pipeline.stop();
+    printf("Pipelined frames identical to serial over %d frames\n", LIFE_FRAMES);
+}
+
+// Restart the pipeline on a board already drawn with its dying cells, as
+// the firmware does after every zoom, rule change or jump, and check each
+// frame against a full redraw of a grid stepped in lockstep
+template <int VW, int VH>
+void check_restart(int x0, int y0) {
+    using Grid = BitLife<LIFE_X, LIFE_Y>;
+    auto piped = std::make_unique<Grid>();
+    auto serial = std::make_unique<Grid>();
+    HostFramebuffer fb, want;
+    piped->clear();
+    serial->clear();
+    seed_soup(*piped, LIFE_X, LIFE_Y, 2000, 21);
+    seed_soup(*serial, LIFE_X, LIFE_Y, 2000, 21);
+
+    auto redraw = [&](HostFramebuffer& out, const Grid& grid) {
+        for (int y = 0; y < VH; y++) {
+            for (int x = 0; x < VW; x++) {
+                blit_cell<LIFE_SIZE>(out.pixels.data(), HostFramebuffer::WIDTH, x, y,
+                                     LIFE_PALETTE[grid.state(x0 + x, y0 + y)]);
+            }
+        }
+    };
+
+    LifePipeline<Grid, VW, VH, 3> pipeline(*piped);
+    pipeline.set_origin(x0, y0);
+    int generation = 0, dying = 0;
+    for (int restart = 0; restart < 5; restart++) {
+        // Leave dying cells on the board, then draw it in full
+        for (int i = 0; i < 3; i++, generation++) {
+            piped->step();
+            serial->step();
+        }
+        for (int y = 0; y < VH; y++) {
+            for (int x = 0; x < VW; x++) dying += piped->state(x0 + x, y0 + y) == LIFE_DYING;
+        }
+        redraw(fb, *piped);
+        pipeline.start();
+        for (int f = 0; f < 20; f++, generation++) {
+            pipeline.next([&](int x, int y, uint8_t state) {
+                blit_cell<LIFE_SIZE>(fb.pixels.data(), HostFramebuffer::WIDTH, x, y, LIFE_PALETTE[state]);
+            });
+            serial->step();
+            redraw(want, *serial);
+            BENCH_CHECK(fb.pixels == want.pixels, "restart %d generation %d differs", restart, generation);
+        }
+        pipeline.stop();
+        // Bring the grid back to the view, as the firmware counts it on
+        for (int i = pipeline.ahead(); i > 0; i--) serial->step();
+        generation += pipeline.ahead();
+        BENCH_CHECK(piped->hash() == serial->hash(), "restart %d grids differ", restart);
+    }
+    BENCH_CHECK(dying > 0, "no dying cells drawn before a restart");
+    printf("Restarts on a %dx%d view with %d dying cells drawn match full redraws\n", VW, VH, dying);
+}
+
+template <int W, int H>
+void throughput(int frames, uint64_t display_us) {
+    using Grid = BitLife<W, H>;
+    auto serial = std::make_unique<Grid>();
+    auto piped = std::make_unique<Grid>();
+    serial->clear();
+    piped->clear();
+    serial->set_skip_stable(false);
+    piped->set_skip_stable(false);
+    seed_soup(*serial, W, H, W * H / 4, 3);
+    seed_soup(*piped, W, H, W * H / 4, 3);
+
+    long changes_serial = 0, changes_piped = 0;
+    uint64_t t0 = now_us();
+    for (int f = 0; f < frames; f++) {
+        serial->step([&](int, int, uint8_t) { changes_serial++; });
+        display_transfer(display_us);
+    }
+    uint64_t serial_us = now_us() - t0;
+
+    auto pipeline = std::make_unique<LifePipeline<Grid>>(*piped);
+    t0 = now_us();
+    pipeline->start();
+    for (int f = 0; f < frames; f++) {
+        pipeline->next([&](int, int, uint8_t) { changes_piped++; });
+        display_transfer(display_us);
+    }
+    uint64_t piped_us = now_us() - t0;
+    pipeline->stop();
+
+    BENCH_CHECK(changes_serial == changes_piped, "%ld vs %ld changes", changes_serial, changes_piped);
+    printf("%4dx%-4d display %4lluus   serial %7.1f fps   pipelined %7.1f fps   x%.2f\n",
+           W, H, (unsigned long long)display_us,
+           frames * 1e6 / serial_us, frames * 1e6 / piped_us, (double)serial_us / piped_us);
+}
+
+int main() {
+    check_identical();
+    check_restart<LIFE_X, LIFE_Y>(0, 0);
+    check_restart<64, 48>(21, 17);
+    throughput<1024, 1024>(200, 300);
+    throughput<1024, 1024>(200, 1000);
+    throughput<1024, 1024>(200, 3000);
+    return 0;
+}
@@ -0,0 +1,196 @@
+/**
+ * Slideshow prefetch on the worker
+ *
+ * Runs ImagePrefetcher with the Worker's host thread standing in for
+ * core1 and libpng for PNGdec, over the images in test_images/. Checks
+ * that a prefetched image expands to the framebuffer a direct decode
+ * gives, and the state machine around it: asking for another image, an
+ * image too busy for the staging buffer, cancelling mid-decode and a new
+ * request replacing an old one. Like PNGdec, the decode cannot be stopped
+ * from a row: it runs to the end, with rows after a full stage or a
+ * cancel dropped. Then reports the hide latency: what the
+ * slideshow waits for between images when it decodes on demand, when the
+ * prefetch has had the display period to finish, and when it is asked
+ * for straight away.
+ */
+
+#include <string.h>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bench.hpp"
+#include "host_png.hpp"
+#include "image_prefetch.hpp"
+
+#ifndef TEST_IMAGE_DIR
+#define TEST_IMAGE_DIR "test_images"
+#endif
+
+constexpr int W = HostFramebuffer::WIDTH;
+constexpr int H = HostFramebuffer::HEIGHT;
+
+// As PREFETCH_STAGING in main.cpp
+constexpr int STAGING = 16 * 1024;
+
+using Stage = ImageStage<W, STAGING / 2>;
+using Prefetcher = ImagePrefetcher<W, H, Stage>;
+
+const char* const IMAGES[] = {"tufty-name", "tufty1", "tufty2", "tufty3", "tufty4", "tufty5"};
+
+// Past the test images: random pixels, which do not fit the staging buffer
+constexpr int NOISE = sizeof(IMAGES) / sizeof(IMAGES[0]);
+
+struct Source {
+    std::vector<std::vector<uint8_t>> files;
+    std::atomic<int> row_delay_us{0};  // Slows decoding down, to cancel in the middle
+    int rows_decoded = 0;
+    int rows_staged = 0;
+};
+
+std::vector<uint8_t> read_file(const std::string& path) {
+    FILE* f = fopen(path.c_str(), "rb");
+    BENCH_CHECK(f, "cannot open %s", path.c_str());
+    std::vector<uint8_t> data;
+    uint8_t buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) data.insert(data.end(), buf, buf + n);
+    fclose(f);
+    return data;
+}
+
+// The worker's decode: the whole image with libpng, then row by row into
+// the stage as png_stage_callback() hands PNGdec's rows over, every one
+// of them whatever the stage says
+bool decode(int index, Stage& stage, void* ctx) {
+    Source& src = *(Source*)ctx;
+    static HostFramebuffer fb;
+    static std::vector<uint8_t> rgb;
+    src.rows_decoded = 0;
+    src.rows_staged = 0;
+    if (index == NOISE) {
+        BenchRand rand(index);
+        for (uint16_t& px : fb.pixels) px = (uint16_t)rand.next();
+    } else if (!decode_png(src.files[index], fb, rgb)) {
+        return false;
+    }
+    for (int y = 0; y < H; y++) {
+        if (src.row_delay_us) std::this_thread::sleep_for(std::chrono::microseconds(src.row_delay_us));
+        if (stage.row(y, &fb.pixels[y * W], W)) src.rows_staged++;
+        src.rows_decoded++;
+    }
+    return true;
+}
+
+Source source;
+Prefetcher prefetcher(decode, &source);
+
+bool take(int index, HostFramebuffer& fb) {
+    return prefetcher.take(index, fb.pixels.data());
+}
+
+void wait_done() {
+    while (prefetcher.state() == PrefetchState::Loading) std::this_thread::sleep_for(std::chrono::microseconds(50));
+}
+
+int main() {
+    std::vector<HostFramebuffer> want(NOISE);
+    std::vector<uint8_t> rgb;
+    for (int i = 0; i < NOISE; i++) {
+        source.files.push_back(read_file(std::string(TEST_IMAGE_DIR) + "/" + IMAGES[i] + ".png"));
+        BENCH_CHECK(decode_png(source.files[i], want[i], rgb), "%s.png did not decode to %dx%d", IMAGES[i], W, H);
+    }
+
+    // Every image prefetches, stages within the budget and expands exactly
+    printf("image        staged bytes  of %d\n", STAGING);
+    HostFramebuffer fb;
+    for (int i = 0; i < NOISE; i++) {
+        prefetcher.request(i);
+        BENCH_CHECK(prefetcher.index() == i, "prefetching %d, asked for %d", prefetcher.index(), i);
+        wait_done();
+        BENCH_CHECK(prefetcher.state() == PrefetchState::Ready, "%s did not stage", IMAGES[i]);
+        BENCH_CHECK(take(i, fb), "%s: take failed", IMAGES[i]);
+        BENCH_CHECK(fb.pixels == want[i].pixels, "%s: prefetched framebuffer differs from a direct decode",
+                    IMAGES[i]);
+        BENCH_CHECK(prefetcher.state() == PrefetchState::Idle && prefetcher.index() == -1, "%s: not idle after take",
+                    IMAGES[i]);
+        printf("%-12s %12d\n", IMAGES[i], prefetcher.staged_bytes());
+    }
+
+    // Asking for another image stops the worker and leaves fb alone
+    HostFramebuffer before = fb;
+    prefetcher.request(1);
+    BENCH_CHECK(!take(2, fb), "took image 1 for image 2");
+    BENCH_CHECK(fb.pixels == before.pixels, "a missed take wrote to the framebuffer");
+    BENCH_CHECK(prefetcher.state() == PrefetchState::Idle, "not idle after a missed take");
+
+    // Nothing requested, nothing to take
+    BENCH_CHECK(!take(1, fb), "took an image nobody asked for");
+
+    // Too busy to stage: failed, and the slideshow loads it itself
+    prefetcher.request(NOISE);
+    wait_done();
+    BENCH_CHECK(prefetcher.state() == PrefetchState::Failed, "random pixels fit in %d bytes", STAGING);
+    BENCH_CHECK(source.rows_staged < H, "rows staged after the stage filled up");
+    BENCH_CHECK(!take(NOISE, fb), "took an image that did not fit");
+    BENCH_CHECK(fb.pixels == before.pixels, "a failed take wrote to the framebuffer");
+    printf("Noise overflowed the stage after %d of %d rows\n", source.rows_staged, H);
+
+    // Cancelling mid-decode drops the remaining rows, but waits for them
+    source.row_delay_us = 1000;
+    prefetcher.request(3);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    uint64_t t0 = now_us();
+    prefetcher.cancel();
+    uint64_t cancel_us = now_us() - t0;
+    BENCH_CHECK(prefetcher.state() == PrefetchState::Idle, "not idle after cancel");
+    BENCH_CHECK(source.rows_staged < H, "rows staged after cancel");
+    BENCH_CHECK(source.rows_decoded == H, "cancel returned with the decode still running");
+    BENCH_CHECK(!take(3, fb), "took a cancelled image");
+    printf("Cancelled after %d of %d rows staged, waiting %llu us for the decode to finish\n", source.rows_staged,
+           H, (unsigned long long)cancel_us);
+
+    // A new request replaces one still loading
+    prefetcher.request(4);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    source.row_delay_us = 0;
+    prefetcher.request(5);
+    BENCH_CHECK(!take(4, fb), "took a replaced request");
+    prefetcher.request(5);
+    BENCH_CHECK(take(5, fb) && fb.pixels == want[5].pixels, "replacing request failed");
+    printf("Prefetch states check out\n");
+
+    // Hide latency: best of several runs of the gap between images
+    printf("\nimage        on demand   prefetched   asked at once   hidden\n");
+    double total_demand = 0, total_swap = 0;
+    for (int i = 0; i < NOISE; i++) {
+        double demand = 1e30, swap = 1e30, at_once = 1e30;
+        for (int run = 0; run < 15; run++) {
+            uint64_t t0 = now_us();
+            decode_png(source.files[i], fb, rgb);
+            uint64_t t1 = now_us();
+            if (t1 - t0 < demand) demand = (double)(t1 - t0);
+
+            prefetcher.request(i);
+            wait_done();  // The display period
+            t0 = now_us();
+            take(i, fb);
+            t1 = now_us();
+            if (t1 - t0 < swap) swap = (double)(t1 - t0);
+
+            t0 = now_us();
+            prefetcher.request(i);
+            take(i, fb);
+            t1 = now_us();
+            if (t1 - t0 < at_once) at_once = (double)(t1 - t0);
+        }
+        BENCH_CHECK(fb.pixels == want[i].pixels, "%s: timed prefetch differs", IMAGES[i]);
+        total_demand += demand;
+        total_swap += swap;
+        printf("%-12s %8.0f us %9.1f us %12.0f us %7.1f%%\n", IMAGES[i], demand, swap, at_once,
+               100.0 * (demand - swap) / demand);
+    }
+    printf("total        %8.0f us %9.1f us %23.1f%%\n", total_demand, total_swap,
+           100.0 * (total_demand - total_swap) / total_demand);
+    return 0;
+}
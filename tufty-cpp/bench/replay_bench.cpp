@@ -0,0 +1,118 @@
+/**
+ * Headless Life replay
+ *
+ * Checks that replay_life() is a fixed workload: the firmware's soup
+ * matches the benchmarks' seed_soup(), the same seed gives the same
+ * checksum every time and with every kernel, tile-skipping and sparse
+ * setting, different seeds differ, and the checksum of the reference run
+ * is the one recorded below (a kernel change that moves it changed the
+ * results). Then times the reference run on the firmware's grid type for
+ * each kernel, printing the same line the badge prints for
+ * "replay <generations> [seed]":
+ *
+ *     replay_bench [generations [seed]]
+ */
+
+#include <stdlib.h>
+#include <memory>
+#include "bench.hpp"
+#include "life.hpp"
+#include "life_lut.hpp"
+#include "life_replay.hpp"
+
+// The firmware's universe
+using Grid = BitLife<320, 240>;
+
+constexpr uint32_t REFERENCE_SEED = 12345;
+constexpr uint32_t REFERENCE_GENERATIONS = 1000;
+constexpr uint64_t REFERENCE_CHECKSUM = 0x0a01262f698f6cc6;
+
+template <typename Rule, template <typename> class Kernel>
+void step(Grid& grid) {
+    grid.template step_with<Kernel<Rule>>([](int, int, uint8_t) {});
+}
+
+LifeReplay replay(Grid& grid, uint32_t seed, uint32_t generations, void (*fn)(Grid&)) {
+    return replay_life(grid, seed, generations, fn, now_us);
+}
+
+void check_soup() {
+    auto a = std::make_unique<Grid>(), b = std::make_unique<Grid>();
+    a->clear();
+    b->clear();
+    uint32_t seed = 99;
+    seed_life_soup(*a, seed, Grid::WIDTH * Grid::HEIGHT / 4);
+    seed_soup(*b, Grid::WIDTH, Grid::HEIGHT, Grid::WIDTH * Grid::HEIGHT / 4, 99);
+    BENCH_CHECK(a->hash() == b->hash(), "seed_life_soup() differs from seed_soup()");
+}
+
+void check_replays() {
+    auto grid = std::make_unique<Grid>();
+    const uint32_t seed = REFERENCE_SEED, n = REFERENCE_GENERATIONS;
+    LifeReplay want = replay(*grid, seed, n, step<ConwayRule, SwarKernel>);
+    printf("  seed %u, %u generations: checksum %016llx, %u alive\n", seed, n, (unsigned long long)want.checksum,
+           want.population);
+    BENCH_CHECK(want.checksum == REFERENCE_CHECKSUM, "checksum %016llx, recorded %016llx",
+                (unsigned long long)want.checksum, (unsigned long long)REFERENCE_CHECKSUM);
+
+    struct Variant {
+        const char* name;
+        void (*fn)(Grid&);
+        bool skip_stable;
+        uint32_t sparse_limit;
+    };
+    const Variant variants[] = {
+        {"again", step<ConwayRule, SwarKernel>, true, Grid::WIDTH * Grid::HEIGHT / LIFE_SPARSE_DENSITY},
+        {"lut kernel", step<ConwayRule, LutKernel>, true, Grid::WIDTH * Grid::HEIGHT / LIFE_SPARSE_DENSITY},
+        {"every tile", step<ConwayRule, SwarKernel>, false, 0},
+        {"always sparse", step<ConwayRule, SwarKernel>, true, UINT32_MAX},
+    };
+    for (const Variant& v : variants) {
+        grid->set_skip_stable(v.skip_stable);
+        grid->set_sparse_limit(v.sparse_limit);
+        LifeReplay r = replay(*grid, seed, n, v.fn);
+        BENCH_CHECK(r.checksum == want.checksum && r.population == want.population, "%s: checksum %016llx",
+                    v.name, (unsigned long long)r.checksum);
+    }
+    grid->set_skip_stable(true);
+    grid->set_sparse_limit(Grid::WIDTH * Grid::HEIGHT / LIFE_SPARSE_DENSITY);
+
+    BENCH_CHECK(replay(*grid, seed + 1, n, step<ConwayRule, SwarKernel>).checksum != want.checksum,
+                "another seed, same checksum");
+    BENCH_CHECK(replay(*grid, seed, n, step<HighLifeRule, SwarKernel>).checksum != want.checksum,
+                "another rule, same checksum");
+    BENCH_CHECK(replay(*grid, seed, n - 1, step<ConwayRule, SwarKernel>).checksum != want.checksum,
+                "one generation fewer, same checksum");
+}
+
+void bench(uint32_t generations, uint32_t seed) {
+    auto grid = std::make_unique<Grid>();
+    const struct {
+        const char* kernel;
+        void (*fn)(Grid&);
+    } kernels[] = {
+        {"swar", step<ConwayRule, SwarKernel>},
+        {"lut", step<ConwayRule, LutKernel>},
+    };
+    for (const auto& k : kernels) {
+        LifeReplay best{};
+        for (int run = 0; run < 5; run++) {
+            LifeReplay r = replay(*grid, seed, generations, k.fn);
+            if (run == 0 || r.us < best.us) best = r;
+        }
+        printf("replay: seed=%u rule=%s generations=%u checksum=%016llx population=%u time=%lluus "
+               "(%.1f gens/s) [%s, best of 5]\n", best.seed, ConwayRule::NAME, best.generations,
+               (unsigned long long)best.checksum, best.population, (unsigned long long)best.us,
+               best.us ? best.generations * 1e6 / best.us : 0.0, k.kernel);
+    }
+}
+
+int main(int argc, char** argv) {
+    uint32_t generations = argc > 1 ? strtoul(argv[1], nullptr, 10) : REFERENCE_GENERATIONS;
+    uint32_t seed = argc > 2 ? strtoul(argv[2], nullptr, 10) : REFERENCE_SEED;
+    check_soup();
+    check_replays();
+    printf("Replays are deterministic across kernels and settings\n");
+    bench(generations, seed);
+    return 0;
+}
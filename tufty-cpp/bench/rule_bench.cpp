@@ -0,0 +1,143 @@
+/**
+ * B/S rule kernels vs a reference simulator
+ *
+ * Checks every rule in the firmware's table, through the bit-sliced and
+ * lookup-table kernels, against a plain byte-per-cell
+ * simulator. Then times each rule, direct and through the runtime dispatch
+ * table, next to the Conway kernel.
+ */
+
+#include <memory>
+#include <vector>
+#include "bench.hpp"
+#include "life.hpp"
+#include "life_lut.hpp"
+
+// Straightforward outer-totalistic simulator, outer ring held dead
+struct RuleReference {
+    int w, h;
+    uint16_t birth, survive;
+    std::vector<uint8_t> cur, prev;
+
+    RuleReference(int w, int h, uint16_t birth, uint16_t survive)
+        : w(w), h(h), birth(birth), survive(survive), cur(w * h), prev(w * h) {}
+
+    void set(int x, int y) { cur[y * w + x] = 1; }
+
+    void step() {
+        std::vector<uint8_t> next(w * h);
+        for (int y = 1; y < h - 1; y++) {
+            for (int x = 1; x < w - 1; x++) {
+                int n = 0;
+                for (int dy = -1; dy <= 1; dy++) {
+                    for (int dx = -1; dx <= 1; dx++) {
+                        if (dx || dy) n += cur[(y + dy) * w + x + dx];
+                    }
+                }
+                next[y * w + x] = ((cur[y * w + x] ? survive : birth) >> n) & 1;
+            }
+        }
+        prev.swap(cur);
+        cur.swap(next);
+    }
+
+    uint8_t state(int x, int y) const {
+        if (cur[y * w + x]) return LIFE_ALIVE;
+        if (prev[y * w + x]) return LIFE_DYING;
+        return LIFE_DEAD;
+    }
+};
+
+constexpr int W = 106;
+constexpr int H = 80;
+
+using Grid = BitLife<W, H>;
+
+template <typename Rule>
+using LutRuleKernel = LutKernel<Rule>;
+
+const LifeRuleEntry<Grid> RULES[] = {
+    life_rule_entry<Grid, ConwayRule>(),
+    life_rule_entry<Grid, HighLifeRule>(),
+    life_rule_entry<Grid, DayNightRule>(),
+    life_rule_entry<Grid, SeedsRule>(),
+    life_rule_entry<Grid, MorleyRule>(),
+};
+
+const LifeRuleEntry<Grid> LUT_RULES[] = {
+    life_rule_entry<Grid, ConwayRule, LutRuleKernel>(),
+    life_rule_entry<Grid, HighLifeRule, LutRuleKernel>(),
+    life_rule_entry<Grid, DayNightRule, LutRuleKernel>(),
+    life_rule_entry<Grid, SeedsRule, LutRuleKernel>(),
+    life_rule_entry<Grid, MorleyRule, LutRuleKernel>(),
+};
+
+constexpr int RULE_COUNT = sizeof(RULES) / sizeof(RULES[0]);
+
+void check_kernel(const LifeRuleEntry<Grid>& rule, const char* kernel, int generations) {
+    RuleReference ref(W, H, rule.birth, rule.survive);
+    auto life = std::make_unique<Grid>();
+    life->clear();
+    seed_soup(ref, W, H, W * H / 4, 23);
+    seed_soup(*life, W, H, W * H / 4, 23);
+    for (int g = 0; g < generations; g++) {
+        ref.step();
+        rule.step(*life);
+        for (int y = 0; y < H; y++) {
+            for (int x = 0; x < W; x++) {
+                BENCH_CHECK(ref.state(x, y) == life->state(x, y), "%s (%s) gen %d cell (%d,%d)", rule.name, kernel, g, x,
+                            y);
+            }
+        }
+    }
+}
+
+template <typename Rule>
+uint64_t time_direct(int generations) {
+    auto life = std::make_unique<Grid>();
+    life->clear();
+    life->set_skip_stable(false);
+    seed_soup(*life, W, H, W * H / 4, 5);
+    uint64_t t0 = now_us();
+    for (int g = 0; g < generations; g++) life->step_with<SwarKernel<Rule>>([](int, int, uint8_t) {});
+    return now_us() - t0;
+}
+
+uint64_t time_table(const LifeRuleEntry<Grid>& rule, int generations) {
+    auto life = std::make_unique<Grid>();
+    life->clear();
+    life->set_skip_stable(false);
+    seed_soup(*life, W, H, W * H / 4, 5);
+    uint64_t t0 = now_us();
+    for (int g = 0; g < generations; g++) rule.step(*life);
+    return now_us() - t0;
+}
+
+void report(const char* name, uint64_t direct_us, uint64_t table_us, uint64_t conway_us, int generations) {
+    double cells = (double)W * H * generations;
+    printf("%-26s direct %7.1f  table %7.1f Mcells/s  (%.2fx Conway)\n", name, cells / direct_us, cells / table_us,
+           (double)conway_us / direct_us);
+}
+
+int main() {
+    for (int i = 0; i < RULE_COUNT; i++) {
+        check_kernel(RULES[i], "swar", 200);
+        check_kernel(LUT_RULES[i], "lut", 200);
+    }
+    printf("%d rules match the reference simulator (swar, lut)\n", RULE_COUNT);
+
+    // Every tile recomputed so all rules do the same amount of work. The
+    // Conway kernel is the former hardcoded B3/S23 adder path, unchanged.
+    const int generations = 5000;
+    uint64_t conway_us = time_direct<ConwayRule>(generations);
+    report(RULES[0].name, conway_us, time_table(RULES[0], generations), conway_us, generations);
+    report(RULES[1].name, time_direct<HighLifeRule>(generations), time_table(RULES[1], generations), conway_us,
+           generations);
+    report(RULES[2].name, time_direct<DayNightRule>(generations), time_table(RULES[2], generations), conway_us,
+           generations);
+    report(RULES[3].name, time_direct<SeedsRule>(generations), time_table(RULES[3], generations), conway_us,
+           generations);
+    report(RULES[4].name, time_direct<MorleyRule>(generations), time_table(RULES[4], generations), conway_us,
+           generations);
+    return 0;
+}
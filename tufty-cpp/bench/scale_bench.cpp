@@ -0,0 +1,224 @@
+/**
+ * Fitting images of any size to the screen
+ *
+ * Feeds images to ImageScaler a row at a time through its one line
+ * buffer, as png_draw_callback() does, and checks the framebuffer it
+ * leaves: test images at full size unchanged, smaller crops centred on
+ * black, 2:1 images exactly halved by both filters, and images of awkward
+ * sizes against a whole-image reference that works out every sample
+ * position in floating point. Then reports scaling throughput in source
+ * and screen pixels per second.
+ */
+
+#include <math.h>
+#include <algorithm>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "bench.hpp"
+#include "host_png.hpp"
+#include "image_scale.hpp"
+
+#ifndef TEST_IMAGE_DIR
+#define TEST_IMAGE_DIR "test_images"
+#endif
+
+constexpr int W = HostFramebuffer::WIDTH;
+constexpr int H = HostFramebuffer::HEIGHT;
+
+// As IMAGE_MAX_WIDTH in main.cpp
+constexpr int MAX_W = 640;
+
+ImageScaler<W, H, MAX_W> scaler;
+
+const char* const IMAGES[] = {"tufty-name", "tufty1", "tufty2", "tufty3", "tufty4", "tufty5"};
+
+struct Image {
+    int w, h;
+    std::vector<uint16_t> px;
+
+    Image(int w, int h) : w(w), h(h), px((size_t)w * h) {}
+    uint16_t& at(int x, int y) { return px[(size_t)y * w + x]; }
+    uint16_t at(int x, int y) const { return px[(size_t)y * w + x]; }
+};
+
+std::vector<uint8_t> read_file(const std::string& path) {
+    FILE* f = fopen(path.c_str(), "rb");
+    BENCH_CHECK(f, "cannot open %s", path.c_str());
+    std::vector<uint8_t> data;
+    uint8_t buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) data.insert(data.end(), buf, buf + n);
+    fclose(f);
+    return data;
+}
+
+Image random_image(int w, int h, uint32_t seed) {
+    Image img(w, h);
+    BenchRand rand(seed);
+    for (uint16_t& p : img.px) p = (uint16_t)(rand.next() ^ (rand.next() << 1));
+    return img;
+}
+
+// Decode img row by row into fb through the scaler's line buffer. The
+// border is painted a colour no test image uses at the corners, so
+// anything left unpainted shows.
+bool fit(const Image& img, ScaleFilter filter, HostFramebuffer& fb) {
+    if (!scaler.begin(img.w, img.h, filter)) return false;
+    for (uint16_t& p : fb.pixels) p = 0x1234;
+    scaler.clear_border(fb.pixels.data(), 0);
+    for (int y = 0; y < img.h; y++) {
+        uint16_t* line = scaler.line();
+        memcpy(line, &img.px[(size_t)y * img.w], img.w * 2);
+        scaler.row(y, line, fb.pixels.data());
+    }
+    return true;
+}
+
+uint16_t average(std::initializer_list<uint16_t> pixels) {
+    uint32_t r = 0, g = 0, b = 0;
+    for (uint16_t be : pixels) {
+        uint16_t c = (uint16_t)((be >> 8) | (be << 8));
+        r += c >> 11;
+        g += (c >> 5) & 0x3F;
+        b += c & 0x1F;
+    }
+    uint16_t c = (uint16_t)((((r + 2) >> 2) << 11) | (((g + 2) >> 2) << 5) | ((b + 2) >> 2));
+    return (uint16_t)((c >> 8) | (c << 8));
+}
+
+// The whole-image reference: the same placement, every sample position
+// from the screen pixel's centre in floating point
+HostFramebuffer reference(const Image& img, ScaleFilter filter) {
+    HostFramebuffer fb;
+    double scale = 1;
+    if (img.w > W || img.h > H) {
+        double sx = floor(img.w * 65536.0 / W), sy = floor(img.h * 65536.0 / H);
+        scale = (sx > sy ? sx : sy) / 65536.0;
+    }
+    int ow = std::clamp((int)floor(img.w / scale), 1, W), oh = std::clamp((int)floor(img.h / scale), 1, H);
+    int ox = (W - ow) / 2, oy = (H - oh) / 2;
+    for (int y = 0; y < oh; y++) {
+        for (int x = 0; x < ow; x++) {
+            double cx = (x + 0.5) * scale, cy = (y + 0.5) * scale;
+            uint16_t p;
+            if (scale == 1) {
+                p = img.at(x, y);
+            } else if (filter == ScaleFilter::Nearest) {
+                p = img.at(std::min((int)floor(cx), img.w - 1), std::min((int)floor(cy), img.h - 1));
+            } else {
+                int x0 = std::min(std::max((int)floor(cx - 0.5), 0), img.w - 1);
+                int y0 = std::min(std::max((int)floor(cy - 0.5), 0), img.h - 1);
+                int x1 = std::min(x0 + 1, img.w - 1), y1 = std::min(y0 + 1, img.h - 1);
+                p = average({img.at(x0, y0), img.at(x1, y0), img.at(x0, y1), img.at(x1, y1)});
+            }
+            fb.pixels[(oy + y) * W + ox + x] = p;
+        }
+    }
+    return fb;
+}
+
+const char* filter_name(ScaleFilter f) { return f == ScaleFilter::Nearest ? "nearest" : "box"; }
+
+// Best of several runs of fitting img, in microseconds
+double best_us(const Image& img, ScaleFilter filter, HostFramebuffer& fb) {
+    double best = 1e30;
+    for (int run = 0; run < 15; run++) {
+        uint64_t t0 = now_us();
+        fit(img, filter, fb);
+        double us = (double)(now_us() - t0);
+        if (us < best) best = us;
+    }
+    return best;
+}
+
+int main() {
+    const ScaleFilter filters[] = {ScaleFilter::Nearest, ScaleFilter::Box};
+    std::vector<Image> screens;
+    std::vector<uint8_t> rgb;
+    for (const char* name : IMAGES) {
+        HostFramebuffer decoded;
+        BENCH_CHECK(decode_png(read_file(std::string(TEST_IMAGE_DIR) + "/" + name + ".png"), decoded, rgb),
+                    "%s.png did not decode to %dx%d", name, W, H);
+        Image img(W, H);
+        img.px = decoded.pixels;
+        screens.push_back(img);
+    }
+
+    HostFramebuffer fb;
+    for (size_t i = 0; i < screens.size(); i++) {
+        const Image& img = screens[i];
+        for (ScaleFilter f : filters) {
+            // Full size: unchanged
+            BENCH_CHECK(fit(img, f, fb) && !scaler.scaled(), "%s: full-size image rejected or scaled", IMAGES[i]);
+            BENCH_CHECK(fb.pixels == img.px, "%s: full-size image changed (%s)", IMAGES[i], filter_name(f));
+
+            // Smaller: centred 1:1 on black, odd sizes rounding left and up
+            Image crop(101, 51);
+            for (int y = 0; y < crop.h; y++)
+                for (int x = 0; x < crop.w; x++) crop.at(x, y) = img.at(x + 30, y + 40);
+            BENCH_CHECK(fit(crop, f, fb) && scaler.x() == 109 && scaler.y() == 94, "%s: crop placed at %d,%d",
+                        IMAGES[i], scaler.x(), scaler.y());
+            BENCH_CHECK(fb.pixels == reference(crop, f).pixels, "%s: crop not centred on black", IMAGES[i]);
+
+            // Twice the size with each pixel doubled: halved exactly
+            Image doubled(2 * W, 2 * H);
+            for (int y = 0; y < doubled.h; y++)
+                for (int x = 0; x < doubled.w; x++) doubled.at(x, y) = img.at(x / 2, y / 2);
+            BENCH_CHECK(fit(doubled, f, fb) && scaler.width() == W && scaler.height() == H,
+                        "%s: 2:1 image not scaled to the screen", IMAGES[i]);
+            BENCH_CHECK(fb.pixels == img.px, "%s: 2:1 image not halved exactly (%s)", IMAGES[i], filter_name(f));
+        }
+    }
+
+    // 2:1 with every pixel different: box is the plain 2x2 average, nearest
+    // the bottom-right of each block
+    Image noise = random_image(2 * W, 2 * H, 7);
+    BENCH_CHECK(fit(noise, ScaleFilter::Box, fb), "2:1 noise rejected");
+    for (int y = 0; y < H; y++)
+        for (int x = 0; x < W; x++)
+            BENCH_CHECK(fb.pixels[y * W + x] == average({noise.at(2 * x, 2 * y), noise.at(2 * x + 1, 2 * y),
+                                                         noise.at(2 * x, 2 * y + 1), noise.at(2 * x + 1, 2 * y + 1)}),
+                        "box at %d,%d is not the 2x2 average", x, y);
+    BENCH_CHECK(fit(noise, ScaleFilter::Nearest, fb), "2:1 noise rejected");
+    for (int y = 0; y < H; y++)
+        for (int x = 0; x < W; x++)
+            BENCH_CHECK(fb.pixels[y * W + x] == noise.at(2 * x + 1, 2 * y + 1), "nearest at %d,%d", x, y);
+    printf("Test images: full size, centred and 2:1 check out\n");
+
+    // Awkward sizes against the reference
+    const int sizes[][2] = {{321, 240}, {320, 241}, {640, 100}, {200, 900}, {333, 777}, {640, 640}, {500, 241},
+                            {1, 1000}, {640, 1}, {1, 1}, {319, 5000}, {639, 479}};
+    for (const auto& s : sizes) {
+        Image img = random_image(s[0], s[1], (uint32_t)(s[0] * 7919 + s[1]));
+        for (ScaleFilter f : filters) {
+            BENCH_CHECK(fit(img, f, fb), "%dx%d rejected", s[0], s[1]);
+            BENCH_CHECK(scaler.width() <= W && scaler.height() <= H && scaler.x() >= 0 && scaler.y() >= 0,
+                        "%dx%d placed off screen", s[0], s[1]);
+            BENCH_CHECK(!scaler.scaled() || scaler.width() >= W - 1 || scaler.height() >= H - 1,
+                        "%dx%d scaled to %dx%d, short of the screen", s[0], s[1], scaler.width(), scaler.height());
+            BENCH_CHECK(fb.pixels == reference(img, f).pixels, "%dx%d differs from the reference (%s)", s[0], s[1],
+                        filter_name(f));
+        }
+        printf("  %4dx%-4d -> %3dx%-3d at %3d,%-3d\n", s[0], s[1], scaler.width(), scaler.height(), scaler.x(),
+               scaler.y());
+    }
+    BENCH_CHECK(!scaler.begin(MAX_W + 1, 10, ScaleFilter::Box), "image wider than %d accepted", MAX_W);
+    BENCH_CHECK(!scaler.begin(0, 10, ScaleFilter::Box), "empty image accepted");
+    printf("Awkward sizes match the reference\n\n");
+
+    // Throughput, rows handed over from memory as the decoder would
+    printf("source      filter    screen      time    source Mpx/s  screen Mpx/s\n");
+    const int timed[][2] = {{320, 240}, {160, 120}, {640, 480}, {480, 360}, {333, 777}, {640, 100}};
+    for (const auto& s : timed) {
+        Image img = random_image(s[0], s[1], 99);
+        for (ScaleFilter f : filters) {
+            double us = best_us(img, f, fb);
+            int screen = scaler.width() * scaler.height();
+            printf("%4dx%-4d   %-8s %3dx%-3d %8.1f us %12.1f %13.1f\n", s[0], s[1], filter_name(f), scaler.width(),
+                   scaler.height(), us, (double)s[0] * s[1] / us, screen / us);
+            if (!scaler.scaled()) break;  // Both filters copy at 1:1
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,172 @@
+/**
+ * Sparse stepping for thinly populated boards
+ *
+ * Checks that sparse steps leave the same planes, hash, LifeStats and
+ * emitted changes as dense ones, for both layouts, the one- and two-row
+ * kernels and a rule other than Conway, including switching back and
+ * forth as the population crosses the limit and cells added with set().
+ * Then charts step time against population on the 320x240 universe for
+ * dense and sparse steps, and checks that switching automatically at
+ * one alive cell in LIFE_SPARSE_DENSITY is never much slower than the
+ * faster of the two. A grid with LifeStats switched off recounts its
+ * population every LIFE_SPARSE_RECOUNT dense steps, so it goes sparse at
+ * most that many steps late, and never when the tracked grid does not.
+ */
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include "bench.hpp"
+#include "life.hpp"
+#include "life_lut.hpp"
+
+struct Change {
+    int16_t x, y;
+    uint8_t state;
+    bool operator==(const Change& o) const { return x == o.x && y == o.y && state == o.state; }
+    bool operator<(const Change& o) const { return y != o.y ? y < o.y : x < o.x; }
+};
+
+// Scatter `patches` 6x6 squares of 50% soup, which burn out into the
+// gliders, oscillators and still lifes of a thinned-out board
+template <typename Grid>
+void seed_patches(Grid& g, int patches, uint32_t seed) {
+    BenchRand r(seed);
+    for (int i = 0; i < patches; i++) {
+        int x0 = 2 + r.next() % (Grid::WIDTH - 10), y0 = 2 + r.next() % (Grid::HEIGHT - 10);
+        for (int j = 0; j < 18; j++) g.set(x0 + r.next() % 6, y0 + r.next() % 6);
+    }
+}
+
+template <typename Grid, typename Kernel>
+void check_sparse(const char* name, uint32_t limit) {
+    auto dense = std::make_unique<Grid>();
+    auto sparse = std::make_unique<Grid>();
+    auto untracked = std::make_unique<Grid>();
+    for (Grid* g : {dense.get(), sparse.get(), untracked.get()}) {
+        g->clear();
+        seed_patches(*g, 12, 17);
+    }
+    dense->set_sparse_limit(0);
+    sparse->set_sparse_limit(limit);
+    untracked->set_sparse_limit(limit);
+    untracked->set_track_stats(false);
+
+    int sparse_steps = 0, switches = 0, late = 0;
+    bool was_sparse = false;
+    std::vector<Change> want, got;
+    for (int g = 0; g < 1500; g++) {
+        if (g == 700) {
+            // A burst of cells in the middle of a run, pushing the
+            // population past the limit for a while
+            for (Grid* grid : {dense.get(), sparse.get(), untracked.get()}) seed_patches(*grid, 40, 18);
+        }
+        want.clear();
+        got.clear();
+        dense->template step_with<Kernel>([&](int x, int y, uint8_t s) { want.push_back({(int16_t)x, (int16_t)y, s}); });
+        sparse->template step_with<Kernel>([&](int x, int y, uint8_t s) { got.push_back({(int16_t)x, (int16_t)y, s}); });
+        untracked->template step_with<Kernel>([](int, int, uint8_t) {});
+        BENCH_CHECK(!dense->sparse_active(), "%s gen %d: dense grid stepped sparsely", name, g);
+        BENCH_CHECK(untracked->hash() == sparse->hash(), "%s gen %d: grid without LifeStats stepped differently", name,
+                    g);
+        BENCH_CHECK(!untracked->sparse_active() || sparse->sparse_active(),
+                    "%s gen %d: grid without LifeStats stepped sparsely alone", name, g);
+        late = sparse->sparse_active() && !untracked->sparse_active() ? late + 1 : 0;
+        BENCH_CHECK(late <= LIFE_SPARSE_RECOUNT, "%s gen %d: grid without LifeStats %d steps late going sparse", name,
+                    g, late);
+        BENCH_CHECK(!untracked->sparse_active() || untracked->stats().population == sparse->stats().population,
+                    "%s gen %d: population without LifeStats", name, g);
+        sparse_steps += sparse->sparse_active();
+        switches += sparse->sparse_active() != was_sparse;
+        was_sparse = sparse->sparse_active();
+
+        // The two-row kernel emits row pairs word by word when dense
+        std::sort(want.begin(), want.end());
+        std::sort(got.begin(), got.end());
+        BENCH_CHECK(got == want, "%s gen %d: %zu changes emitted, %zu dense", name, g, got.size(), want.size());
+        BENCH_CHECK(sparse->hash() == dense->hash(), "%s gen %d: hash", name, g);
+        LifeStats a = sparse->stats(), b = dense->stats();
+        BENCH_CHECK(a.population == b.population && a.births == b.births && a.deaths == b.deaths && a.x0 == b.x0 &&
+                        a.y0 == b.y0 && a.x1 == b.x1 && a.y1 == b.y1,
+                    "%s gen %d: stats", name, g);
+        for (int y = 0; y < Grid::HEIGHT; y++) {
+            for (int x = 0; x < Grid::WIDTH; x++) {
+                BENCH_CHECK(sparse->state(x, y) == dense->state(x, y), "%s gen %d: cell (%d,%d)", name, g, x, y);
+            }
+        }
+    }
+    BENCH_CHECK(sparse_steps > 0 && switches >= 2, "%s: %d sparse steps, %d switches", name, sparse_steps, switches);
+    printf("  %-22s %4d of 1500 steps sparse, %d switches\n", name, sparse_steps, switches);
+}
+
+struct Timing {
+    double us = 1e30;        // Per generation, best of the runs
+    double population = 0;   // Average
+    double sparse = 0;       // Share of steps taken sparsely
+};
+
+// One run of `generations` steps after the patches have burnt in
+template <typename Grid>
+void time_steps(Grid& life, int patches, uint32_t limit, int generations, Timing& t) {
+    life.clear();
+    life.set_sparse_limit(0);
+    seed_patches(life, patches, 40 + patches);
+    for (int g = 0; g < 100; g++) life.step();
+    life.set_sparse_limit(limit);
+    uint64_t population = 0, sparse = 0;
+    uint64_t t0 = now_us();
+    for (int g = 0; g < generations; g++) {
+        life.step();
+        population += life.stats().population;
+        sparse += life.sparse_active();
+    }
+    double us = (double)(now_us() - t0) / generations;
+    if (us < t.us) t.us = us;
+    t.population = (double)population / generations;
+    t.sparse = (double)sparse / generations;
+}
+
+template <int W, int H>
+void chart() {
+    using Grid = BitLife<W, H>;
+    const int counts[] = {1, 2, 4, 8, 12, 16, 24, 32, 48, 64, 96, 128, 192, 256, 384};
+    const uint32_t limit = W * H / LIFE_SPARSE_DENSITY;
+    auto life = std::make_unique<Grid>();
+    printf("%dx%d, sparse up to %u cells; us per generation\n", W, H, limit);
+    printf("patches  population  density    dense   sparse     auto (sparse steps)\n");
+    for (int patches : counts) {
+        // Interleaved, so a slow patch of the machine hits all three, and
+        // measured again if automatic falls behind, as a noisy host can
+        // make it for a whole round
+        Timing dense, sparse, automatic;
+        double best = 0;
+        for (int attempt = 0; attempt < 3; attempt++) {
+            dense = sparse = automatic = Timing();
+            for (int run = 0; run < 9; run++) {
+                time_steps(*life, patches, 0, 400, dense);
+                time_steps(*life, patches, UINT32_MAX, 400, sparse);
+                time_steps(*life, patches, limit, 400, automatic);
+            }
+            best = dense.us < sparse.us ? dense.us : sparse.us;
+            if (automatic.us <= best * 1.25 + 0.1) break;
+        }
+        printf("%7d  %10.0f  %6.2f%%  %7.2f  %7.2f%s  %7.2f (%3.0f%%)\n", patches, dense.population,
+               100.0 * dense.population / (W * H), dense.us, sparse.us, sparse.sparse < 1 ? "*" : " ", automatic.us,
+               automatic.sparse * 100);
+        BENCH_CHECK(automatic.us <= best * 1.25 + 0.1, "%d patches: automatic %.2f us, best %.2f us", patches,
+                    automatic.us, best);
+    }
+    printf("(* some steps fell back to dense: more than %d words to compute)\n", LIFE_SPARSE_WORDS);
+}
+
+int main() {
+    check_sparse<BitLife<106, 80>, SwarKernel<>>("106x80 row-major", 150);
+    check_sparse<BitLife<106, 80, LifeLayout::ColumnMajor>, SwarKernel<>>("106x80 column-major", 150);
+    check_sparse<BitLife<256, 160>, LutKernel<>>("256x160 lut", 300);
+    check_sparse<BitLife<320, 240>, SwarKernel<HighLifeRule>>("320x240 highlife", 300);
+    printf("Sparse steps match dense ones\n");
+
+    chart<320, 240>();
+    chart<106, 80>();
+    return 0;
+}
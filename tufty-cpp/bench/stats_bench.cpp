@@ -0,0 +1,145 @@
+/**
+ * Incremental population, birth/death and bounding box counters
+ *
+ * Checks BitLife's stats() against a brute-force recount of the board
+ * after every generation, for both layouts, the one- and two-row kernels
+ * and a rule other than Conway, including cells added with set() between
+ * generations. Then reports what keeping the counters costs per
+ * generation, on a fresh soup and on one that has settled, next to the
+ * step itself and to recounting the population from scratch.
+ */
+
+#include <memory>
+#include <vector>
+#include "bench.hpp"
+#include "life.hpp"
+#include "life_lut.hpp"
+
+struct Recount {
+    uint32_t population = 0, births = 0, deaths = 0;
+    int x0 = 0, y0 = 0, x1 = -1, y1 = -1;
+};
+
+template <typename Grid>
+std::vector<uint8_t> alive_cells(const Grid& grid) {
+    std::vector<uint8_t> cells(Grid::WIDTH * Grid::HEIGHT);
+    for (int y = 0; y < Grid::HEIGHT; y++) {
+        for (int x = 0; x < Grid::WIDTH; x++) cells[y * Grid::WIDTH + x] = grid.alive(x, y);
+    }
+    return cells;
+}
+
+template <typename Grid>
+Recount recount(const std::vector<uint8_t>& before, const std::vector<uint8_t>& after) {
+    Recount r;
+    r.x0 = Grid::WIDTH;
+    r.y0 = Grid::HEIGHT;
+    for (int y = 0; y < Grid::HEIGHT; y++) {
+        for (int x = 0; x < Grid::WIDTH; x++) {
+            uint8_t a = before[y * Grid::WIDTH + x], b = after[y * Grid::WIDTH + x];
+            r.population += b;
+            r.births += b && !a;
+            r.deaths += a && !b;
+            if (a != b) {
+                if (x < r.x0) r.x0 = x;
+                if (y < r.y0) r.y0 = y;
+                if (x > r.x1) r.x1 = x;
+                if (y > r.y1) r.y1 = y;
+            }
+        }
+    }
+    if (r.x1 < 0) r.x0 = r.y0 = 0;
+    return r;
+}
+
+template <typename Grid, typename Kernel>
+void check_stats(const char* name) {
+    auto life = std::make_unique<Grid>();
+    life->clear();
+    LifeStats s = life->stats();
+    BENCH_CHECK(s.population == 0 && s.x0 > s.x1, "%s: empty grid", name);
+    seed_soup(*life, Grid::WIDTH, Grid::HEIGHT, Grid::WIDTH * Grid::HEIGHT / 4, 11);
+    std::vector<uint8_t> cells = alive_cells(*life);
+    BENCH_CHECK(life->stats().population == recount<Grid>(cells, cells).population, "%s: seeded population", name);
+
+    BenchRand r(12);
+    for (int g = 0; g < 300; g++) {
+        if (g % 50 == 49) {
+            // Cells added between generations, some of them already alive
+            for (int i = 0; i < 40; i++) life->set(1 + r.next() % (Grid::WIDTH - 2), 1 + r.next() % (Grid::HEIGHT - 2));
+            cells = alive_cells(*life);
+        }
+        life->template step_with<Kernel>([](int, int, uint8_t) {});
+        std::vector<uint8_t> next = alive_cells(*life);
+        Recount want = recount<Grid>(cells, next);
+        s = life->stats();
+        BENCH_CHECK(s.population == want.population, "%s gen %d: population %u, recount %u", name, g, s.population,
+                    want.population);
+        BENCH_CHECK(s.births == want.births && s.deaths == want.deaths, "%s gen %d: +%u -%u, recount +%u -%u", name,
+                    g, s.births, s.deaths, want.births, want.deaths);
+        BENCH_CHECK(s.x0 == want.x0 && s.y0 == want.y0 && s.x1 == want.x1 && s.y1 == want.y1,
+                    "%s gen %d: box %d,%d-%d,%d, recount %d,%d-%d,%d", name, g, s.x0, s.y0, s.x1, s.y1, want.x0,
+                    want.y0, want.x1, want.y1);
+        cells.swap(next);
+    }
+}
+
+// Best step time over interleaved runs with and without the counters,
+// from a fresh soup and from one that has had `settle` generations to
+// calm down, and the time one brute-force population recount takes
+template <int W, int H>
+void bench(int generations, int settle) {
+    using Grid = BitLife<W, H>;
+    auto life = std::make_unique<Grid>();
+    typename Grid::Plane plane;
+
+    printf("%4dx%-4d", W, H);
+    for (int warm : {0, settle}) {
+        uint64_t best[2] = {UINT64_MAX, UINT64_MAX};
+        for (int run = 0; run < 8; run++) {
+            for (int track = 0; track < 2; track++) {
+                // Dense steps throughout, and no population recounts
+                // for the sparse switch while the counters are off
+                life->clear();
+                life->set_sparse_limit(0);
+                life->set_track_stats(false);
+                seed_soup(*life, W, H, W * H / 4, 13);
+                for (int g = 0; g < warm; g++) life->step();
+                life->set_track_stats(track);
+                uint64_t t0 = now_us();
+                for (int g = 0; g < generations; g++) life->step();
+                uint64_t us = now_us() - t0;
+                if (us < best[track]) best[track] = us;
+            }
+        }
+        double step = (double)best[0] / generations, counted = (double)best[1] / generations;
+        printf("  %s %7.2f us, counted %7.2f us (%+5.1f%%)", warm ? "settled" : "soup", step, counted,
+               100.0 * (counted - step) / step);
+    }
+
+    volatile uint32_t sink = 0;
+    uint64_t t0 = now_us();
+    for (int g = 0; g < generations; g++) {
+        life->snapshot(plane);
+        uint32_t population = 0;
+        for (int y = 0; y < Grid::SH; y++) {
+            for (int k = 0; k < Grid::WORDS; k++) population += life_popcount(plane[y][k]);
+        }
+        sink = sink + population;
+    }
+    printf("  recount %6.2f us\n", (double)(now_us() - t0) / generations);
+}
+
+int main() {
+    check_stats<BitLife<106, 80>, SwarKernel<>>("106x80 row-major");
+    check_stats<BitLife<106, 80, LifeLayout::ColumnMajor>, SwarKernel<>>("106x80 column-major");
+    check_stats<BitLife<256, 160>, LutKernel<>>("256x160 lut");
+    check_stats<BitLife<320, 240>, SwarKernel<HighLifeRule>>("320x240 highlife");
+    printf("Incremental counters match a brute-force recount\n");
+
+    printf("Best step time per generation, without and with the counters:\n");
+    bench<106, 80>(500, 1000);
+    bench<320, 240>(200, 1000);
+    bench<1024, 1024>(20, 1000);
+    return 0;
+}
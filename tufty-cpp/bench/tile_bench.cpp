@@ -0,0 +1,88 @@
+/**
+ * Tile activity tracking: speedup versus soup density
+ *
+ * Runs LIFE_FRAMES generations of the 106x80 board with stable-tile
+ * skipping on and off, checks both stay in step with the reference kernel
+ * and emit the same number of changed cells, then reports time per run,
+ * average active tiles per frame and the speedup. Once most tiles are
+ * active the engine steps them all, so dense soups should come out even.
+ */
+
+#include "bench.hpp"
+#include "life.hpp"
+
+constexpr int LIFE_X = 106;
+constexpr int LIFE_Y = 80;
+constexpr int LIFE_FRAMES = 500;
+constexpr int RUNS = 20;
+constexpr int ATTEMPTS = 3;
+
+using Grid = BitLife<LIFE_X, LIFE_Y>;
+
+struct RunResult {
+    uint64_t us;
+    long tiles;
+    long emitted;
+};
+
+RunResult run(bool skip, int dots, uint32_t seed) {
+    Grid life;
+    RunResult r = {0, 0, 0};
+    for (int run = 0; run < RUNS; run++) {
+        life.clear();
+        life.set_skip_stable(skip);
+        seed_soup(life, LIFE_X, LIFE_Y, dots, seed + run);
+        uint64_t t0 = now_us();
+        for (int f = 0; f < LIFE_FRAMES; f++) {
+            life.step([&](int, int, uint8_t) { r.emitted++; });
+            r.tiles += life.active_tiles();
+        }
+        r.us += now_us() - t0;
+    }
+    return r;
+}
+
+void check(int dots, uint32_t seed) {
+    ReferenceLife ref(LIFE_X, LIFE_Y);
+    Grid life;
+    life.clear();
+    seed_soup(ref, LIFE_X, LIFE_Y, dots, seed);
+    seed_soup(life, LIFE_X, LIFE_Y, dots, seed);
+    for (int f = 0; f < LIFE_FRAMES; f++) {
+        ref.step();
+        life.step();
+        for (int x = 0; x < LIFE_X; x++) {
+            for (int y = 0; y < LIFE_Y; y++) {
+                BENCH_CHECK(ref.state(x, y) == life.state(x, y), "dots %d frame %d cell (%d,%d)", dots, f, x, y);
+            }
+        }
+    }
+}
+
+int main() {
+    const int densities[] = {2, 5, 10, 20, 35, 50};
+
+    for (int pct : densities) check(LIFE_X * LIFE_Y * pct / 100, 99);
+    printf("Tiled engine matches reference kernel\n");
+
+    printf("%d frames x %d runs, %d tiles\n", LIFE_FRAMES, RUNS, Grid::TILE_COUNT);
+    printf("density   full us   tiled us   active tiles/frame   speedup\n");
+    for (int pct : densities) {
+        int dots = LIFE_X * LIFE_Y * pct / 100;
+        // Best of a few interleaved tries, as the host's timing is noisy
+        RunResult full = run(false, dots, 5);
+        RunResult tiled = run(true, dots, 5);
+        for (int attempt = 1; attempt < ATTEMPTS; attempt++) {
+            uint64_t us = run(false, dots, 5).us;
+            if (us < full.us) full.us = us;
+            us = run(true, dots, 5).us;
+            if (us < tiled.us) tiled.us = us;
+        }
+        BENCH_CHECK(full.emitted == tiled.emitted, "emitted %ld vs %ld", full.emitted, tiled.emitted);
+        printf("  %3d%%   %8llu   %8llu   %10.1f / %d       x%.2f\n", pct,
+               (unsigned long long)full.us, (unsigned long long)tiled.us,
+               (double)tiled.tiles / (LIFE_FRAMES * RUNS), Grid::TILE_COUNT,
+               (double)full.us / (double)(tiled.us ? tiled.us : 1));
+    }
+    return 0;
+}
@@ -0,0 +1,217 @@
+/**
+ * Slideshow prefetch and the display transfer
+ *
+ * Runs ImagePrefetcher with the firmware's run-length coded staging,
+ * checks that it puts the image a direct decode gives in the framebuffer
+ * and that the frame being sent is never written mid-transfer. Then sums
+ * up the firmware's RAM: the framebuffer, the file lists and the mode
+ * arena, whose slideshow half holds PNGdec, the scaler and the stage,
+ * against the budget main.cpp checks, next to what a whole back frame
+ * would add instead of the staging.
+ *
+ * The display is modelled: sending a frame takes send_us, spread over its
+ * rows, as the blocking st7789.update() does on core0. A slideshow
+ * transition is timed from taking the next image to having it sent and
+ * the one after staged, with the prefetch requested after the transfer
+ * (serial) and before it (overlapped, as main() does), for decodes slowed
+ * down to badge-like times.
+ *
+ *     transfer_bench [send_us]
+ */
+
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include "bench.hpp"
+#include "host_png.hpp"
+#include "image_prefetch.hpp"
+#include "image_scale.hpp"
+#include "life.hpp"
+#include "life_pipeline.hpp"
+#include "generations.hpp"
+#include "life_cycle.hpp"
+#include "life_age.hpp"
+
+#ifndef TEST_IMAGE_DIR
+#define TEST_IMAGE_DIR "test_images"
+#endif
+
+constexpr int W = HostFramebuffer::WIDTH;
+constexpr int H = HostFramebuffer::HEIGHT;
+constexpr int FRAME_BYTES = W * H * 2;
+
+// As PREFETCH_STAGING in main.cpp
+constexpr int STAGING = 16 * 1024;
+
+// As RAM_SIZE - RAM_RESERVE in main.cpp: the RP2040's main SRAM less
+// what the SDK, USB stdio and LittleFS need
+constexpr int RAM_BUDGET = 256 * 1024 - 24 * 1024;
+
+// sizeof(PNG) with PNGdec's default buffers: the 32 KB zlib window, the
+// inflate state and the line and file buffers
+constexpr int PNGDEC_BYTES = 48 * 1024;
+
+// image_list and pattern_list in main.cpp
+constexpr int FILE_LISTS = 200 * 32 + 32 * 32;
+
+// Life's half of the mode arena, as LifeState in main.cpp
+struct LifeState {
+    BitLife<W, H> life;
+    LifePipeline<BitLife<W, H>, W / 2, H / 2, 3> pipeline{life};
+    GenerationsLife<W / 3, H / 3> generations;
+    LifeCycleDetector<16> cycles;
+    LifeAge<W / 3, H / 3> ages;
+};
+
+const char* const IMAGES[] = {"tufty-name", "tufty1", "tufty2", "tufty3", "tufty4", "tufty5"};
+constexpr int IMAGE_COUNT = sizeof(IMAGES) / sizeof(IMAGES[0]);
+
+struct Source {
+    std::vector<std::vector<uint8_t>> files;
+    std::atomic<int> row_delay_us{0};  // Brings decoding up to the badge's pace
+};
+
+Source source;
+
+std::vector<uint8_t> read_file(const std::string& path) {
+    FILE* f = fopen(path.c_str(), "rb");
+    BENCH_CHECK(f, "cannot open %s", path.c_str());
+    std::vector<uint8_t> data;
+    uint8_t buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) data.insert(data.end(), buf, buf + n);
+    fclose(f);
+    return data;
+}
+
+// The worker's decode, as in prefetch_bench
+template <typename Stage>
+bool decode(int index, Stage& stage, void* ctx) {
+    Source& src = *(Source*)ctx;
+    static HostFramebuffer fb;
+    static std::vector<uint8_t> rgb;
+    if (!decode_png(src.files[index], fb, rgb)) return false;
+    for (int y = 0; y < H; y++) {
+        if (src.row_delay_us) std::this_thread::sleep_for(std::chrono::microseconds(src.row_delay_us));
+        stage.row(y, &fb.pixels[y * W], W);
+    }
+    return true;
+}
+
+using StagingPrefetcher = ImagePrefetcher<W, H, ImageStage<W, STAGING / 2>>;
+
+StagingPrefetcher prefetcher(decode, &source);
+
+uint64_t checksum(const uint16_t* frame) {
+    uint64_t h = 1469598103934665603ull;
+    for (int i = 0; i < W * H; i++) h = (h ^ frame[i]) * 1099511628211ull;
+    return h;
+}
+
+// The modelled display transfer: reads the frame row by row over send_us,
+// returning the checksum of what went out
+uint64_t send(const uint16_t* frame, int send_us) {
+    uint64_t h = 1469598103934665603ull;
+    uint64_t t0 = now_us();
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) h = (h ^ frame[y * W + x]) * 1099511628211ull;
+        uint64_t due = t0 + (uint64_t)send_us * (y + 1) / H;
+        while (now_us() < due) std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+    return h;
+}
+
+void wait_done() {
+    while (prefetcher.state() == PrefetchState::Loading) std::this_thread::sleep_for(std::chrono::microseconds(50));
+}
+
+// Every image through the prefetcher matches want, the framebuffer it
+// should end up as
+void check_images(const std::vector<HostFramebuffer>& want) {
+    HostFramebuffer frame;
+    uint16_t* fb = frame.pixels.data();
+    for (int i = 0; i < IMAGE_COUNT; i++) {
+        prefetcher.request(i);
+        wait_done();
+        BENCH_CHECK(prefetcher.take(i, fb), "%s did not stage", IMAGES[i]);
+        BENCH_CHECK(memcmp(fb, want[i].pixels.data(), FRAME_BYTES) == 0, "%s differs", IMAGES[i]);
+    }
+}
+
+// One transition per image: take it, send it and have the next one staged.
+// Returns the average in microseconds; checks nothing was written to the
+// frame while it was being sent.
+double transition_us(bool overlap, int send_us) {
+    HostFramebuffer frame;
+    uint16_t* fb = frame.pixels.data();
+    prefetcher.request(0);
+    wait_done();
+    uint64_t total = 0;
+    for (int i = 0; i < IMAGE_COUNT; i++) {
+        int next = (i + 1) % IMAGE_COUNT;
+        uint64_t t0 = now_us();
+        BENCH_CHECK(prefetcher.take(i, fb), "%s did not stage", IMAGES[i]);
+        uint64_t before = checksum(fb);
+        if (overlap) prefetcher.request(next);
+        uint64_t sent = send(fb, send_us);
+        if (!overlap) prefetcher.request(next);
+        wait_done();
+        total += now_us() - t0;
+        BENCH_CHECK(sent == before && checksum(fb) == before, "%s was written while it was sent", IMAGES[i]);
+    }
+    prefetcher.cancel();
+    return (double)total / IMAGE_COUNT;
+}
+
+int main(int argc, char** argv) {
+    // A full frame over the 8-bit parallel bus, taken as 10 MB/s
+    int send_us = argc > 1 ? atoi(argv[1]) : FRAME_BYTES / 10;
+
+    std::vector<HostFramebuffer> want(IMAGE_COUNT);
+    std::vector<uint8_t> rgb;
+    for (int i = 0; i < IMAGE_COUNT; i++) {
+        source.files.push_back(read_file(std::string(TEST_IMAGE_DIR) + "/" + IMAGES[i] + ".png"));
+        BENCH_CHECK(decode_png(source.files[i], want[i], rgb), "%s.png did not decode to %dx%d", IMAGES[i], W, H);
+    }
+    check_images(want);
+    printf("Staged images match a direct decode\n\n");
+
+    // The firmware's RAM with the staging, and with a whole back frame in
+    // its place: RGB332 at a byte a pixel, or a second framebuffer
+    const int life_bytes = (int)sizeof(LifeState);
+    const int image_bytes = PNGDEC_BYTES + (int)sizeof(ImageScaler<W, H, 640>);
+    printf("%d byte framebuffer, %d of file lists, arena of Life %d or PNGdec and scaler %d + stage\n",
+           FRAME_BYTES, FILE_LISTS, life_bytes, image_bytes);
+    printf("stage           bytes     arena     total   of %d budget\n", RAM_BUDGET);
+    struct Footprint {
+        const char* name;
+        int stage;
+    } footprints[] = {
+        {"none", 0},
+        {"staging", (int)sizeof(StagingPrefetcher)},
+        {"rgb332 frame", W * H},
+        {"rgb565 frame", FRAME_BYTES},
+    };
+    for (const Footprint& f : footprints) {
+        int arena = std::max(life_bytes, image_bytes + f.stage);
+        int total = FRAME_BYTES + FILE_LISTS + arena;
+        printf("%-12s %8d %9d %9d %10.0f%%%s\n", f.name, f.stage, arena, total, 100.0 * total / RAM_BUDGET,
+               total > RAM_BUDGET ? "  over" : "");
+    }
+    int staged = FRAME_BYTES + FILE_LISTS + std::max(life_bytes, image_bytes + (int)sizeof(StagingPrefetcher));
+    BENCH_CHECK(staged <= RAM_BUDGET, "the staging prefetcher is over budget");
+
+    printf("\nsend %d us per frame\n", send_us);
+    printf("decode delay     serial   overlapped   gain\n");
+    for (int decode_ms : {0, 20, 80, 200}) {
+        source.row_delay_us = decode_ms * 1000 / H;
+        double serial = transition_us(false, send_us);
+        double overlapped = transition_us(true, send_us);
+        printf("%9d ms %10.1f ms %10.1f ms %7.1f%%\n", decode_ms, serial / 1000, overlapped / 1000,
+               100.0 * (serial - overlapped) / serial);
+    }
+    return 0;
+}
@@ -0,0 +1,140 @@
+/**
+ * Life universe larger than the display
+ *
+ * Checks window snapshots against state(), and that a pipeline panned
+ * around a 256x160 universe draws exactly the viewport of a serially
+ * stepped copy. Then reports generations/second for 256x256, 512x512 and
+ * 1024x1024 universes, soup-filled and with only a screenful active.
+ */
+
+#include <memory>
+#include <vector>
+#include "bench.hpp"
+#include "life.hpp"
+#include "life_pipeline.hpp"
+
+constexpr int VIEW_X = 106;
+constexpr int VIEW_Y = 80;
+
+template <int W, int H>
+void check_windows() {
+    auto life = std::make_unique<BitLife<W, H>>();
+    life->clear();
+    seed_soup(*life, W, H, W * H / 4, 3);
+    for (int g = 0; g < 5; g++) life->step();
+
+    BenchRand r(9);
+    uint32_t window[VIEW_Y][(VIEW_X + 31) / 32];
+    for (int i = 0; i < 40; i++) {
+        int x0 = i == 0 ? 0 : i == 1 ? W - VIEW_X : r.next() % (W - VIEW_X + 1);
+        int y0 = i == 0 ? 0 : i == 1 ? H - VIEW_Y : r.next() % (H - VIEW_Y + 1);
+        life->template snapshot_window<VIEW_X, VIEW_Y>(x0, y0, window);
+        for (int y = 0; y < VIEW_Y; y++) {
+            for (int x = 0; x < (VIEW_X + 31) / 32 * 32; x++) {
+                bool bit = (window[y][x >> 5] >> (x & 31)) & 1;
+                bool want = x < VIEW_X && life->alive(x0 + x, y0 + y);
+                BENCH_CHECK(bit == want, "%dx%d window (%d,%d) cell (%d,%d)", W, H, x0, y0, x, y);
+            }
+        }
+    }
+}
+
+void check_panning() {
+    constexpr int W = 256, H = 160;
+    using Grid = BitLife<W, H>;
+    auto serial = std::make_unique<Grid>();
+    auto piped = std::make_unique<Grid>();
+    serial->clear();
+    piped->clear();
+    seed_soup(*serial, W, H, W * H / 4, 8);
+    seed_soup(*piped, W, H, W * H / 4, 8);
+
+    // What the display shows, in viewport coordinates
+    std::vector<uint8_t> shown(VIEW_X * VIEW_Y);
+    int vx = 70, vy = 40;
+    for (int y = 0; y < VIEW_Y; y++) {
+        for (int x = 0; x < VIEW_X; x++) shown[y * VIEW_X + x] = piped->state(vx + x, vy + y);
+    }
+
+    auto pipeline = std::make_unique<LifePipeline<Grid, VIEW_X, VIEW_Y>>(*piped);
+    pipeline->set_origin(vx, vy);
+    pipeline->start();
+    BenchRand r(4);
+    int moves = 0;
+    for (int f = 0; f < 400; f++) {
+        // Pan in bursts, clamping at the edges like the firmware
+        if (f % 20 < 6) {
+            vx += (int)(r.next() % 17) - 8;
+            vy += (int)(r.next() % 17) - 8;
+            pipeline->set_origin(vx, vy);
+        }
+        bool moved = pipeline->next([&](int x, int y, uint8_t s) { shown[y * VIEW_X + x] = s; });
+        moves += moved;
+        serial->step();
+
+        int ox = pipeline->origin_x(), oy = pipeline->origin_y();
+        for (int y = 0; y < VIEW_Y; y++) {
+            for (int x = 0; x < VIEW_X; x++) {
+                uint8_t want = serial->state(ox + x, oy + y);
+                if (moved && want == LIFE_DYING) want = LIFE_DEAD;
+                BENCH_CHECK(shown[y * VIEW_X + x] == want, "frame %d view (%d,%d) cell (%d,%d)", f, ox, oy, x, y);
+            }
+        }
+    }
+    pipeline->stop();
+    BENCH_CHECK(moves > 0, "viewport never moved");
+}
+
+// Generations per second with every cell seeded, and with only a
+// screenful of soup in the middle of an otherwise empty universe
+template <int W, int H>
+void bench(int generations) {
+    auto life = std::make_unique<BitLife<W, H>>();
+    life->clear();
+    seed_soup(*life, W, H, W * H / 4, 5);
+    uint64_t t0 = now_us();
+    for (int g = 0; g < generations; g++) life->step();
+    uint64_t full_us = now_us() - t0;
+
+    life->clear();
+    BenchRand r(5);
+    for (int i = 0; i < VIEW_X * VIEW_Y / 4; i++) {
+        life->set((W - VIEW_X) / 2 + r.next() % VIEW_X, (H - VIEW_Y) / 2 + r.next() % VIEW_Y);
+    }
+    uint64_t tiles = 0;
+    t0 = now_us();
+    for (int g = 0; g < generations; g++) {
+        life->step();
+        tiles += life->active_tiles();
+    }
+    uint64_t local_us = now_us() - t0;
+
+    // The per-frame cost of cutting out and diffing the viewport
+    using View = BitLife<VIEW_X, VIEW_Y>;
+    View::Plane views[3] = {};
+    uint32_t changes = 0;
+    t0 = now_us();
+    for (int g = 0; g < generations; g++) {
+        life->template snapshot_window<VIEW_X, VIEW_Y>((W - VIEW_X) / 2 + g % 7, (H - VIEW_Y) / 2, views[g % 3]);
+        View::diff(views[(g + 1) % 3], views[(g + 2) % 3], views[g % 3], [&](int, int, uint8_t) { changes++; });
+    }
+    uint64_t view_us = now_us() - t0;
+    BENCH_CHECK(changes > 0, "shifted views should differ");
+
+    printf("%5dx%-5d  soup %8.0f gens/s   screenful %8.0f gens/s (%3.0f/%d tiles)   view cut+diff %5.1f us/frame\n", W, H,
+           generations * 1e6 / full_us, generations * 1e6 / local_us, (double)tiles / generations,
+           BitLife<W, H>::TILE_COUNT, (double)view_us / generations);
+}
+
+int main() {
+    check_windows<256, 160>();
+    check_windows<1024, 1024>();
+    check_windows<VIEW_X, VIEW_Y>();
+    check_panning();
+    printf("Viewport snapshots and panned pipeline match serial stepping\n");
+
+    bench<256, 256>(2000);
+    bench<512, 512>(500);
+    bench<1024, 1024>(200);
+    return 0;
+}
@@ -0,0 +1,178 @@
+/**
+ * Zoom levels: compute and draw cost per cell size
+ *
+ * Checks that a pipeline on a 320x240 universe draws exactly the viewport
+ * of a serially stepped copy at every zoom level, switching levels while
+ * stopped as the firmware does, both with slots for the whole universe
+ * and with the firmware's 160x120 slots, which step the 1 pixel view on
+ * the caller's side. Then, per level, reports the time to step
+ * the universe and cut and diff the view, and the time to draw the
+ * changed cells and a full view with blit_cell<SIZE>() against a
+ * runtime-sized routine that loops over every pixel. Both must leave the
+ * same framebuffer.
+ */
+
+#include <memory>
+#include <vector>
+#include "bench.hpp"
+#include "life.hpp"
+#include "life_render.hpp"
+#include "life_pipeline.hpp"
+
+constexpr int W = HostFramebuffer::WIDTH;
+constexpr int H = HostFramebuffer::HEIGHT;
+constexpr int GENERATIONS = 300;
+
+using Grid = BitLife<W, H>;
+using View = BitLife<W, H>;
+
+// What every level would cost without its own routine: the size is only
+// known at run time, as when dispatching on the zoom level
+__attribute__((noinline)) void blit_cell_any(uint16_t* fb, int stride, int size, int x, int y, uint16_t colour) {
+    for (int j = 0; j < size; j++) {
+        for (int i = 0; i < size; i++) fb[(y * size + j) * stride + x * size + i] = colour;
+    }
+}
+
+struct Change {
+    int16_t x, y;
+    uint8_t state;
+};
+
+template <int VW, int VH>
+void check_zoom_switching() {
+    const int sizes[] = {3, 1, 8, 2, 4, 3};
+    auto serial = std::make_unique<Grid>();
+    auto piped = std::make_unique<Grid>();
+    serial->clear();
+    piped->clear();
+    seed_soup(*serial, W, H, W * H / 4, 6);
+    seed_soup(*piped, W, H, W * H / 4, 6);
+    auto pipeline = std::make_unique<LifePipeline<Grid, VW, VH, 3>>(*piped);
+
+    std::vector<uint8_t> shown(W * H);
+    int f = 0;
+    for (int size : sizes) {
+        int vw = W / size, vh = H / size;
+        int vx = (W - vw) / 2, vy = (H - vh) / 2;
+        pipeline->set_view(vw, vh);
+        pipeline->set_origin(vx, vy);
+        BENCH_CHECK(pipeline->view_width() == vw && pipeline->view_height() == vh, "view size at %dpx", size);
+        BENCH_CHECK(pipeline->serial() == (vw > VW || vh > VH), "%dpx view serial with %dx%d slots", size, VW, VH);
+
+        // A full redraw after switching shows no dying cells
+        for (int y = 0; y < vh; y++) {
+            for (int x = 0; x < vw; x++) shown[y * W + x] = piped->alive(vx + x, vy + y) ? LIFE_ALIVE : LIFE_DEAD;
+        }
+        pipeline->start();
+        for (int g = 0; g < 60; g++, f++) {
+            pipeline->next([&](int x, int y, uint8_t s) {
+                BENCH_CHECK(x < vw && y < vh, "cell (%d,%d) outside the %dx%d view", x, y, vw, vh);
+                shown[y * W + x] = s;
+            });
+            serial->step();
+            for (int y = 0; y < vh; y++) {
+                for (int x = 0; x < vw; x++) {
+                    uint8_t want = serial->state(vx + x, vy + y);
+                    BENCH_CHECK(shown[y * W + x] == want, "%dx%d slots: frame %d at %dpx cell (%d,%d)", VW, VH, f,
+                                size, x, y);
+                }
+            }
+            BENCH_CHECK(pipeline->hash() == serial->hash(), "%dx%d slots: hash at frame %d", VW, VH, f);
+        }
+        pipeline->stop();
+
+        // The worker may have stepped past the last generation drawn
+        for (int i = pipeline->ahead(); i > 0; i--) serial->step();
+        BENCH_CHECK(piped->hash() == serial->hash(), "%dx%d slots: %d generations ahead after stop at %dpx", VW,
+                    VH, pipeline->ahead(), size);
+    }
+}
+
+template <int SIZE>
+void bench_level() {
+    constexpr int VW = W / SIZE, VH = H / SIZE;
+    const int x0 = (W - VW) / 2, y0 = (H - VH) / 2;
+    auto life = std::make_unique<Grid>();
+    life->clear();
+    seed_soup(*life, W, H, W * H / 4, 7);
+
+    // Step, cut and diff, keeping the changes to draw separately
+    auto views = std::make_unique<View::Plane[]>(3);
+    memset(views.get(), 0, 3 * sizeof(View::Plane));
+    std::vector<std::vector<Change>> changes(GENERATIONS);
+    uint64_t t0 = now_us();
+    for (int g = 0; g < GENERATIONS; g++) {
+        life->step();
+        life->template snapshot_window<W, H>(x0, y0, views[g % 3], VW, VH);
+        View::diff(views[(g + 1) % 3], views[(g + 2) % 3], views[g % 3],
+                   [&](int x, int y, uint8_t s) { changes[g].push_back({(int16_t)x, (int16_t)y, s}); }, VH,
+                   (VW + 31) / 32);
+    }
+    uint64_t compute_us = now_us() - t0;
+    size_t changed = 0;
+    for (const auto& c : changes) changed += c.size();
+
+    // Keep the compiler from folding the size back into blit_cell_any()
+    volatile int runtime_size = SIZE;
+    const int size = runtime_size;
+
+    HostFramebuffer fb_special, fb_any;
+    t0 = now_us();
+    for (const auto& gen : changes) {
+        for (const Change& c : gen) blit_cell<SIZE>(fb_special.pixels.data(), W, c.x, c.y, LIFE_PALETTE[c.state]);
+    }
+    uint64_t special_us = now_us() - t0;
+    t0 = now_us();
+    for (const auto& gen : changes) {
+        for (const Change& c : gen) blit_cell_any(fb_any.pixels.data(), W, size, c.x, c.y, LIFE_PALETTE[c.state]);
+    }
+    uint64_t any_us = now_us() - t0;
+    BENCH_CHECK(fb_special.pixels == fb_any.pixels, "%dpx: changed cells drawn differently", SIZE);
+
+    // Full view redraws, as after a pan or zoom
+    constexpr int REDRAWS = 50;
+    std::vector<uint16_t> colours(VW * VH);
+    for (int y = 0; y < VH; y++) {
+        for (int x = 0; x < VW; x++) colours[y * VW + x] = LIFE_PALETTE[life->state(x0 + x, y0 + y)];
+    }
+    t0 = now_us();
+    for (int r = 0; r < REDRAWS; r++) {
+        for (int y = 0; y < VH; y++) {
+            for (int x = 0; x < VW; x++) {
+                blit_cell<SIZE>(fb_special.pixels.data(), W, x, y, colours[y * VW + x]);
+            }
+        }
+    }
+    uint64_t full_special_us = now_us() - t0;
+    t0 = now_us();
+    for (int r = 0; r < REDRAWS; r++) {
+        for (int y = 0; y < VH; y++) {
+            for (int x = 0; x < VW; x++) {
+                blit_cell_any(fb_any.pixels.data(), W, size, x, y, colours[y * VW + x]);
+            }
+        }
+    }
+    uint64_t full_any_us = now_us() - t0;
+    BENCH_CHECK(fb_special.pixels == fb_any.pixels, "%dpx: full view drawn differently", SIZE);
+
+    printf("%dpx  %3dx%-3d  %8.1f  %9.0f  %8.1f  %8.1f  %8.1f  %8.1f\n", SIZE, VW, VH,
+           (double)compute_us / GENERATIONS, (double)changed / GENERATIONS, (double)special_us / GENERATIONS,
+           (double)any_us / GENERATIONS, (double)full_special_us / REDRAWS, (double)full_any_us / REDRAWS);
+}
+
+int main() {
+    check_zoom_switching<W, H>();
+    check_zoom_switching<W / 2, H / 2>();
+    printf("Pipeline views match serial stepping at every zoom level, with %dx%d and %dx%d slots\n", W, H, W / 2,
+           H / 2);
+
+    printf("%dx%d universe, %d generations; times in us\n", W, H, GENERATIONS);
+    printf("zoom view     compute/gen  changes/gen  draw/gen  per-pixel  full view  per-pixel\n");
+    bench_level<1>();
+    bench_level<2>();
+    bench_level<3>();
+    bench_level<4>();
+    bench_level<8>();
+    return 0;
+}
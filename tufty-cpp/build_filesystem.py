@@ -4,19 +4,26 @@ Build LittleFS filesystem image for Tufty 2040 Badge
 
 This script:
 1. Creates a LittleFS filesystem image from a directory of PNG files
-2. Creates a UF2 file for the filesystem
-3. Optionally combines firmware + filesystem into one UF2
+   (or, with --raw565, pre-decoded .565 images the firmware reads straight
+   into its framebuffer; with --blob, images go into a read-only region
+   below the filesystem instead, shown in place from memory-mapped flash)
+2. Optionally adds Game of Life patterns (.rle / .cells) under life/, and
+   life/seed.txt to fix the seed of Life's random soups
+3. Creates a UF2 file for the filesystem
+4. Optionally combines firmware + filesystem into one UF2
 
 Usage:
-    ./build_filesystem.py <image_dir> [--firmware tufty_badge.uf2]
+    ./build_filesystem.py <image_dir> [--raw565] [--blob] [--patterns <pattern_dir>] [--life-seed <n>]
+                          [--firmware tufty_badge.uf2]
 
 Example:
-    ./build_filesystem.py ../pics --firmware build/tufty_badge.uf2
+    ./build_filesystem.py ../pics --patterns test_patterns --firmware build/tufty_badge.uf2
 """
 
 import os
 import sys
 import struct
+import zlib
 import argparse
 from pathlib import Path
 
@@ -31,6 +38,8 @@ except ImportError:
 FLASH_SIZE = 8 * 1024 * 1024      # 8MB total flash
 FS_SIZE = 2 * 1024 * 1024         # 2MB filesystem
 FS_OFFSET = FLASH_SIZE - FS_SIZE  # Filesystem starts here (6MB)
+BLOB_SIZE = 2 * 1024 * 1024       # Image blob (image_blob.hpp), below the filesystem
+BLOB_OFFSET = FS_OFFSET - BLOB_SIZE
 BLOCK_SIZE = 4096                 # Flash sector size (FLASH_SECTOR_SIZE)
 BLOCK_COUNT = FS_SIZE // BLOCK_SIZE
 PROG_SIZE = 256                   # Flash page size (FLASH_PAGE_SIZE)
@@ -107,7 +116,115 @@ def combine_uf2_files(uf2_files):
     return result
 
 
-def build_filesystem(image_dir, output_file):
+# Display size the firmware shows .565 images at
+SCREEN_WIDTH = 320
+SCREEN_HEIGHT = 240
+
+
+def decode_png(data):
+    """Decode an 8-bit, non-interlaced PNG to (width, height, RGB bytes), or
+    None for other kinds. Alpha is dropped, as the firmware's PNG decoder
+    does."""
+    if data[:8] != b'\x89PNG\r\n\x1a\n':
+        return None
+
+    pos = 8
+    idat = b''
+    palette = None
+    while pos + 8 <= len(data):
+        length, kind = struct.unpack('>I4s', data[pos:pos+8])
+        body = data[pos+8:pos+8+length]
+        pos += 12 + length
+        if kind == b'IHDR':
+            width, height, depth, colour, _, _, interlace = struct.unpack('>IIBBBBB', body)
+        elif kind == b'PLTE':
+            palette = body
+        elif kind == b'IDAT':
+            idat += body
+        elif kind == b'IEND':
+            break
+
+    channels = {0: 1, 2: 3, 3: 1, 4: 2, 6: 4}.get(colour)
+    if depth != 8 or interlace or channels is None or (colour == 3 and palette is None):
+        return None
+
+    raw = zlib.decompress(idat)
+    stride = width * channels
+    prev = bytearray(stride)
+    rgb = bytearray()
+    for y in range(height):
+        start = y * (stride + 1)
+        kind = raw[start]
+        row = bytearray(raw[start+1:start+1+stride])
+        for i in range(stride):
+            a = row[i-channels] if i >= channels else 0
+            b = prev[i]
+            if kind == 1:
+                row[i] = (row[i] + a) & 0xFF
+            elif kind == 2:
+                row[i] = (row[i] + b) & 0xFF
+            elif kind == 3:
+                row[i] = (row[i] + ((a + b) >> 1)) & 0xFF
+            elif kind == 4:
+                c = prev[i-channels] if i >= channels else 0
+                p = a + b - c
+                pa, pb, pc = abs(p - a), abs(p - b), abs(p - c)
+                row[i] = (row[i] + (a if pa <= pb and pa <= pc else b if pb <= pc else c)) & 0xFF
+        prev = row
+
+        if colour == 2:
+            rgb += row
+        elif colour == 6:
+            for x in range(width):
+                rgb += row[x*4:x*4+3]
+        elif colour == 3:
+            for x in range(width):
+                rgb += palette[row[x]*3:row[x]*3+3]
+        else:
+            for x in range(width):
+                v = row[x*channels]
+                rgb += bytes((v, v, v))
+    return width, height, bytes(rgb)
+
+
+def png_to_565(data):
+    """Convert a PNG to the firmware's .565 format (image565.hpp): an 8-byte
+    header, then big-endian RGB565 pixels truncated as PNGdec's
+    getLineAsRGB565() does. None if the PNG cannot be converted."""
+    decoded = decode_png(data)
+    if decoded is None:
+        return None
+    width, height, rgb = decoded
+    out = bytearray(b'R565' + struct.pack('<HH', width, height))
+    for i in range(0, len(rgb), 3):
+        r, g, b = rgb[i], rgb[i+1], rgb[i+2]
+        out += struct.pack('>H', ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3))
+    return bytes(out)
+
+
+def build_blob(entries):
+    """Pack (name, data) pairs into the read-only image blob the firmware
+    maps from flash (layout in image_blob.hpp), or None if they do not fit"""
+    header_size = 16 + 32 * len(entries)
+    offset = (header_size + 3) & ~3
+    index = b''
+    body = b''
+    for name, data in entries:
+        encoded = name.encode()
+        if len(encoded) > 23:
+            print(f"Error: blob entry name {name} longer than 23 bytes")
+            return None
+        index += encoded.ljust(24, b'\x00') + struct.pack('<II', offset + len(body), len(data))
+        body += data + b'\x00' * (-len(data) % 4)
+    blob = b'TBLB' + struct.pack('<III', 1, len(entries), offset + len(body))
+    blob += index.ljust(offset - 16, b'\x00') + body
+    if len(blob) > BLOB_SIZE:
+        print(f"Error: {len(blob)} bytes of images do not fit the {BLOB_SIZE} byte blob")
+        return None
+    return blob
+
+
+def build_filesystem(image_dir, output_file, pattern_dir=None, life_seed=None, raw565=False, blob=False):
     """Build LittleFS filesystem image from directory"""
     image_dir = Path(image_dir)
 
@@ -140,6 +257,7 @@ def build_filesystem(image_dir, output_file):
 
     # Copy files
     total_size = 0
+    blob_entries = []
     for png_file in sorted(png_files):
         filename = png_file.name
         fs_path = f'pics/{filename}'
@@ -147,12 +265,61 @@ def build_filesystem(image_dir, output_file):
         with open(png_file, 'rb') as f:
             data = f.read()
 
+        # Full-screen images pre-decoded, anything else left as PNG
+        if raw565:
+            converted = png_to_565(data)
+            if converted is None:
+                print(f"  Keeping {filename} as PNG: not an 8-bit non-interlaced PNG")
+            elif converted[4:8] != struct.pack('<HH', SCREEN_WIDTH, SCREEN_HEIGHT):
+                print(f"  Keeping {filename} as PNG: not {SCREEN_WIDTH}x{SCREEN_HEIGHT}")
+            else:
+                filename = png_file.stem + '.565'
+                fs_path = f'pics/{filename}'
+                data = converted
+
+        if blob:
+            blob_entries.append((filename, data))
+            print(f"  Added: {filename} ({len(data)} bytes, blob)")
+            continue
+
         with fs.open(fs_path, 'wb') as f:
             f.write(data)
 
         print(f"  Added: {filename} ({len(data)} bytes)")
         total_size += len(data)
 
+    # Copy Life patterns
+    if pattern_dir:
+        pattern_dir = Path(pattern_dir)
+        pattern_files = sorted(p for p in pattern_dir.iterdir() if p.suffix.lower() in ('.rle', '.cells'))
+        print(f"Found {len(pattern_files)} Life patterns")
+
+        try:
+            fs.mkdir('life')
+        except:
+            pass
+
+        for pattern_file in pattern_files:
+            with open(pattern_file, 'rb') as f:
+                data = f.read()
+
+            with fs.open(f'life/{pattern_file.name}', 'wb') as f:
+                f.write(data)
+
+            print(f"  Added: life/{pattern_file.name} ({len(data)} bytes)")
+            total_size += len(data)
+
+    # Fixed seed for repeatable Life runs
+    if life_seed is not None:
+        try:
+            fs.mkdir('life')
+        except:
+            pass
+
+        with fs.open('life/seed.txt', 'wb') as f:
+            f.write(f'{life_seed}\n'.encode())
+        print(f"  Added: life/seed.txt (seed {life_seed})")
+
     print(f"Total: {total_size} bytes in filesystem")
 
     # Get the filesystem image
@@ -168,6 +335,18 @@ def build_filesystem(image_dir, output_file):
     fs_addr = FLASH_BASE + FS_OFFSET
     uf2_data = binary_to_uf2(fs_image, fs_addr)
 
+    # Images in the blob region go into the same UF2
+    if blob:
+        blob_image = build_blob(blob_entries)
+        if blob_image is None:
+            return None
+        blob_file = output_file.replace('.uf2', '.blob.bin')
+        with open(blob_file, 'wb') as f:
+            f.write(blob_image)
+        print(f"Wrote image blob: {blob_file} ({len(blob_image)} bytes, {len(blob_entries)} images "
+              f"at offset 0x{BLOB_OFFSET:X})")
+        uf2_data = combine_uf2_files([uf2_data, binary_to_uf2(blob_image, FLASH_BASE + BLOB_OFFSET)])
+
     with open(output_file, 'wb') as f:
         f.write(uf2_data)
     print(f"Wrote UF2 filesystem: {output_file} ({len(uf2_data)} bytes)")
@@ -178,6 +357,13 @@ def build_filesystem(image_dir, output_file):
 def main():
     parser = argparse.ArgumentParser(description='Build LittleFS filesystem for Tufty 2040')
     parser.add_argument('image_dir', help='Directory containing PNG images')
+    parser.add_argument('--raw565', action='store_true',
+                        help='Store full-screen images pre-decoded as .565 (larger, but no PNG decode on device)')
+    parser.add_argument('--blob', action='store_true',
+                        help='Put images in a read-only region below the filesystem, shown in place from flash')
+    parser.add_argument('--patterns', '-p', help='Directory of .rle/.cells Life patterns to add under life/')
+    parser.add_argument('--life-seed', type=lambda s: int(s, 0) & 0xFFFFFFFF,
+                        help='Fix the seed of Life soups (life/seed.txt) for repeatable runs')
     parser.add_argument('--firmware', '-f', help='Firmware UF2 file to combine')
     parser.add_argument('--output', '-o', default='filesystem.uf2', help='Output UF2 file')
 
@@ -187,7 +373,8 @@ def main():
     print(f"Flash config: {FLASH_SIZE//1024//1024}MB total, {FS_SIZE//1024//1024}MB filesystem at offset 0x{FS_OFFSET:X}")
 
     # Build filesystem
-    fs_uf2 = build_filesystem(args.image_dir, args.output)
+    fs_uf2 = build_filesystem(args.image_dir, args.output, args.patterns, args.life_seed, args.raw565,
+                              args.blob)
     if fs_uf2 is None:
         sys.exit(1)
 
@@ -0,0 +1,110 @@
+/**
+ * Tufty 2040 Badge - minimal concurrency layer
+ *
+ * A lock-free single-producer/single-consumer queue and a Worker that runs
+ * a function on the second core. On the RP2040 the worker is core1; on the
+ * host it is a std::thread, so pipelines built on this can be tested and
+ * benchmarked natively.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+
+#if PICO_ON_DEVICE
+#include "pico/platform.h"
+#include "pico/multicore.h"
+#else
+#include <thread>
+#endif
+
+// Fixed-size ring for one producer and one consumer. Only plain atomic
+// loads and stores are used, which are lock-free on the Cortex-M0+.
+template <typename T, int N>
+class SpscQueue {
+    static_assert(N > 0 && (N & (N - 1)) == 0, "queue size must be a power of two");
+
+public:
+    bool push(const T& item) {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == (uint32_t)N) return false;
+        items[t & (N - 1)] = item;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& item) {
+        uint32_t h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) return false;
+        item = items[h & (N - 1)];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Items queued; only exact while neither side is running
+    int size() const {
+        return (int)(tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire));
+    }
+
+    // Only safe while neither side is running
+    void reset() {
+        head.store(0, std::memory_order_relaxed);
+        tail.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    T items[N];
+    std::atomic<uint32_t> head{0};
+    std::atomic<uint32_t> tail{0};
+};
+
+// Runs entry(arg) on the other core. Only one Worker may be running at a
+// time on the device, since there is only one core1.
+class Worker {
+public:
+    void start(void (*entry)(void*), void* arg) {
+        running_entry = entry;
+        running_arg = arg;
+        finished.store(false, std::memory_order_release);
+#if PICO_ON_DEVICE
+        multicore_launch_core1(trampoline);
+#else
+        thread = std::thread(trampoline);
+#endif
+    }
+
+    // Wait for entry() to return; it must be told to stop first
+    void join() {
+#if PICO_ON_DEVICE
+        while (!finished.load(std::memory_order_acquire)) {
+            relax();
+        }
+        multicore_reset_core1();
+#else
+        if (thread.joinable()) thread.join();
+#endif
+    }
+
+    // Called while spinning on a queue
+    static inline void relax() {
+#if PICO_ON_DEVICE
+        tight_loop_contents();
+#else
+        std::this_thread::yield();
+#endif
+    }
+
+private:
+    static void trampoline() {
+        running_entry(running_arg);
+        finished.store(true, std::memory_order_release);
+    }
+
+    static inline void (*running_entry)(void*) = nullptr;
+    static inline void* running_arg = nullptr;
+    static inline std::atomic<bool> finished{false};
+#if !PICO_ON_DEVICE
+    std::thread thread;
+#endif
+};
@@ -0,0 +1,89 @@
+/**
+ * Tufty 2040 Badge - frame pacing
+ *
+ * Schedules Game of Life frames against a target frame rate. A frame
+ * computes and draws some generations, then sends what changed to the
+ * display. The pacer keeps moving averages of what a generation and a
+ * display update cost, and gives each frame as many generations as fit
+ * in the frame period once the update is paid for: several when
+ * computing is cheap, down to one when the display is the bottleneck,
+ * and never more than a cap so the board stays watchable. Frames that
+ * finish early wait for their slot, so the frame rate holds at the
+ * target; frames that overrun do not make the next ones hurry.
+ *
+ * Timestamps are microseconds from the caller (time_us_64() on the
+ * device), so the logic runs on the host against a fake clock.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+class FramePacer {
+public:
+    FramePacer(uint32_t fps, int max_generations) { set_target(fps, max_generations); }
+
+    void set_target(uint32_t fps, int max_generations) {
+        period = 1000000 / (fps ? fps : 1);
+        max_gens = max_generations < 1 ? 1 : max_generations;
+    }
+
+    // Forget the learnt costs and start the first frame slot at now
+    void reset(uint64_t now) {
+        next_slot = now;
+        gen_cost = update_cost = 0;
+        planned = 1;
+    }
+
+    // A frame starts at now: how many generations to compute for it
+    int begin_frame(uint64_t now) {
+        frame_start = now;
+        if (gen_cost == 0) {
+            planned = 1;
+        } else {
+            uint32_t budget = period > update_cost ? period - update_cost : 0;
+            uint32_t n = budget / gen_cost;
+            planned = n < 1 ? 1 : n > (uint32_t)max_gens ? max_gens : (int)n;
+        }
+        return planned;
+    }
+
+    // The frame's generations, possibly fewer than planned, are drawn and
+    // the display update starts at now
+    void computed(uint64_t now, int generations) {
+        compute_end = now;
+        done = generations < 1 ? 1 : generations;
+    }
+
+    // The display update finished at now. Returns the microseconds to wait
+    // before the next frame starts, 0 when running behind.
+    uint32_t end_frame(uint64_t now) {
+        learn(gen_cost, (uint32_t)((compute_end - frame_start) / done));
+        learn(update_cost, (uint32_t)(now - compute_end));
+        next_slot += period;
+        if (next_slot <= now) {
+            next_slot = now;
+            return 0;
+        }
+        return (uint32_t)(next_slot - now);
+    }
+
+    int generations_per_frame() const { return planned; }
+    uint32_t generation_us() const { return gen_cost; }
+    uint32_t update_us() const { return update_cost; }
+    uint32_t period_us() const { return period; }
+
+private:
+    // Exponential moving average over about 8 frames; the first sample
+    // is taken as is. Never 0 once learnt, so it can divide.
+    static void learn(uint32_t& avg, uint32_t sample) {
+        if (sample == 0) sample = 1;
+        avg = avg == 0 ? sample : (uint32_t)((int32_t)avg + ((int32_t)sample - (int32_t)avg) / 8);
+    }
+
+    uint32_t period = 0;
+    int max_gens = 1;
+    uint32_t gen_cost = 0, update_cost = 0;   // Learnt, in microseconds
+    int planned = 1, done = 1;
+    uint64_t next_slot = 0, frame_start = 0, compute_end = 0;
+};
@@ -0,0 +1,157 @@
+/**
+ * Tufty 2040 Badge - Generations automata
+ *
+ * Generations rules extend B/S with decay: a cell that stops being alive
+ * does not die at once but steps through STATES - 2 refractory states, in
+ * which it neither counts as a neighbour nor can be born again. Brian's
+ * Brain (B2/S/3) and Star Wars (B2/S345/4) are the well known ones; with
+ * two states a Generations rule is plain Life.
+ *
+ * States are packed two cells per byte, so at most 16. Only alive cells
+ * count as neighbours, so the alive cells are also kept as a bit plane and
+ * births are found with the bit-sliced kernel from life.hpp. The nibbles
+ * are then visited only where a cell is occupied or being born.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <cstring>
+#include "life.hpp"
+#include "life_render.hpp"
+
+// B/S masks as in LifeRule plus the number of states, dead and alive
+// included
+template <uint16_t BIRTH_MASK, uint16_t SURVIVE_MASK, int STATE_COUNT>
+struct GenerationsRule : LifeRule<BIRTH_MASK, SURVIVE_MASK> {
+    static constexpr int STATES = STATE_COUNT;
+
+    static_assert(STATES >= 2 && STATES <= 16, "states must fit a nibble");
+};
+
+struct BriansBrainRule : GenerationsRule<1 << 2, 0, 3> {
+    static constexpr const char* NAME = "Brian's Brain B2/S/3";
+};
+
+struct StarWarsRule : GenerationsRule<1 << 2, (1 << 3) | (1 << 4) | (1 << 5), 4> {
+    static constexpr const char* NAME = "Star Wars B2/S345/4";
+};
+
+struct XtasyRule : GenerationsRule<(1 << 2) | (1 << 3) | (1 << 5) | (1 << 6),
+                                   (1 << 1) | (1 << 4) | (1 << 5) | (1 << 6), 16> {
+    static constexpr const char* NAME = "Xtasy B2356/S1456/16";
+};
+
+template <int W, int H>
+class GenerationsLife {
+public:
+    static constexpr int WIDTH = W;
+    static constexpr int HEIGHT = H;
+    static constexpr int WORDS = (W + 31) / 32;
+
+    static_assert(W >= 3 && H >= 3, "grid needs an interior");
+
+    void clear() {
+        memset(cells, 0, sizeof(cells));
+        memset(alive, 0, sizeof(alive));
+        memset(occupied, 0, sizeof(occupied));
+        cur = 0;
+    }
+
+    // Make a cell alive
+    void set(int x, int y) {
+        put(x, y, LIFE_ALIVE);
+        alive[cur][y][x >> 5] |= 1u << (x & 31);
+        occupied[y][x >> 5] |= 1u << (x & 31);
+    }
+
+    // LIFE_DEAD, LIFE_ALIVE or a decay state 2 .. STATES - 1
+    uint8_t state(int x, int y) const {
+        return (cells[y][x >> 1] >> ((x & 1) * 4)) & 0xF;
+    }
+
+    template <typename Rule>
+    void step() {
+        step<Rule>([](int, int, uint8_t) {});
+    }
+
+    // Advance one generation under Rule and call emit(x, y, state) for
+    // every cell whose state changed. The outermost ring stays dead.
+    template <typename Rule, typename Emit>
+    void step(Emit&& emit) {
+        const uint32_t (*src)[WORDS] = alive[cur];
+        uint32_t (*dst)[WORDS] = alive[cur ^ 1];
+
+        for (int y = 1; y < H - 1; y++) {
+            for (int k = 0; k < WORDS; k++) {
+                uint32_t now = src[y][k];
+                uint32_t occ = occupied[y][k];
+                // Decaying cells cannot be born
+                uint32_t next = SwarKernel<Rule>::template next_word<WORDS>(src[y - 1], src[y], src[y + 1], k) &
+                                interior.m[k] & ~(occ & ~now);
+                dst[y][k] = next;
+
+                uint32_t visit = occ | next;
+                uint32_t still = 0;
+                while (visit) {
+                    int b = __builtin_ctz(visit);
+                    visit &= visit - 1;
+                    uint32_t bit = 1u << b;
+                    int x = k * 32 + b;
+                    uint8_t s = state(x, y);
+                    uint8_t n;
+                    if (next & bit) {
+                        n = LIFE_ALIVE;
+                    } else {
+                        // Alive cells fall into the first decay state, the
+                        // last decay state back to dead
+                        n = s + 1 == Rule::STATES ? LIFE_DEAD : s + 1;
+                    }
+                    if (n != LIFE_DEAD) still |= bit;
+                    if (n != s) {
+                        put(x, y, n);
+                        emit(x, y, n);
+                    }
+                }
+                occupied[y][k] = still;
+            }
+        }
+        cur ^= 1;
+    }
+
+private:
+    void put(int x, int y, uint8_t s) {
+        uint8_t& byte = cells[y][x >> 1];
+        int shift = (x & 1) * 4;
+        byte = (uint8_t)((byte & ~(0xF << shift)) | (s << shift));
+    }
+
+    // Bits for x in [1, W - 2] within each word
+    struct InteriorMasks {
+        uint32_t m[WORDS];
+        constexpr InteriorMasks() : m() {
+            for (int x = 1; x <= W - 2; x++) m[x >> 5] |= 1u << (x & 31);
+        }
+    };
+    static constexpr InteriorMasks interior = InteriorMasks();
+
+    uint8_t cells[H][(W + 1) / 2] = {};
+    uint32_t alive[2][H][WORDS] = {};     // Current and next alive planes
+    uint32_t occupied[H][WORDS] = {};     // Cells not dead
+    int cur = 0;
+};
+
+// A compiled Generations rule for runtime selection
+template <typename Grid>
+struct GenerationsRuleEntry {
+    const char* name;
+    int states;
+    const uint16_t* palette;
+    void (*step)(Grid&, void (*emit)(int, int, uint8_t));
+};
+
+template <typename Grid, typename Rule>
+constexpr GenerationsRuleEntry<Grid> generations_rule_entry() {
+    return {Rule::NAME, Rule::STATES, GENERATIONS_PALETTE<Rule::STATES>.colour,
+            [](Grid& grid, void (*emit)(int, int, uint8_t)) { grid.template step<Rule>(emit); }};
+}
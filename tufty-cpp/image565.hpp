@@ -0,0 +1,52 @@
+/**
+ * Tufty 2040 Badge - pre-decoded RGB565 images
+ *
+ * A .565 file holds an image already in the framebuffer's format, so the
+ * slideshow reads it straight into graphics.frame_buffer instead of
+ * inflating, unfiltering and converting a PNG on every show.
+ * build_filesystem.py --raw565 writes them. An 8-byte header, then
+ * width * height pixels as big-endian RGB565 (the bytes swapped, as
+ * PicoGraphics_PenRGB565 stores pens), row by row from the top:
+ *
+ *     "R565"     magic
+ *     uint16_t   width, little-endian
+ *     uint16_t   height, little-endian
+ *
+ * The header is 8 bytes so the pixels stay word-aligned in the file.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+constexpr int IMAGE565_HEADER = 8;
+
+struct Image565Info {
+    int width, height;
+
+    // Pixel bytes after the header
+    uint32_t bytes() const { return (uint32_t)width * height * 2; }
+};
+
+// Parse the first IMAGE565_HEADER bytes of a file; false if they are not a
+// .565 header
+inline bool image565_header(const uint8_t* p, Image565Info& info) {
+    if (p[0] != 'R' || p[1] != '5' || p[2] != '6' || p[3] != '5') return false;
+    info.width = p[4] | (p[5] << 8);
+    info.height = p[6] | (p[7] << 8);
+    return info.width > 0 && info.height > 0;
+}
+
+// The pixels of a .565 file held in memory, or nullptr if it is not one
+// or is cut short
+inline const uint8_t* image565_pixels(const uint8_t* data, uint32_t size, Image565Info& info) {
+    if (size < IMAGE565_HEADER || !image565_header(data, info)) return nullptr;
+    return size - IMAGE565_HEADER >= info.bytes() ? data + IMAGE565_HEADER : nullptr;
+}
+
+// Whether a file name ends in .565
+inline bool image565_name(const char* name) {
+    int len = 0;
+    while (name[len]) len++;
+    return len > 4 && name[len - 4] == '.' && name[len - 3] == '5' && name[len - 2] == '6' && name[len - 1] == '5';
+}
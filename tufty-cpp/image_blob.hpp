@@ -0,0 +1,77 @@
+/**
+ * Tufty 2040 Badge - read-only image blob
+ *
+ * A contiguous region of flash, outside LittleFS, holding slideshow
+ * images back to back behind an index, as written by
+ * build_filesystem.py --blob. Flash is memory-mapped (XIP), so an entry
+ * is just a pointer: PNGs are decoded from it in place and pre-decoded
+ * .565 images are sent to the display straight from it, without reading
+ * anything through the filesystem into RAM. On the host the same code
+ * runs against an mmap()ed copy of the region.
+ *
+ * Layout, little-endian:
+ *
+ *     "TBLB"                   magic
+ *     uint32_t version         IMAGE_BLOB_VERSION
+ *     uint32_t count           entries in the index
+ *     uint32_t bytes           whole blob, header included
+ *     count entries of 32 bytes:
+ *         char name[24]        file name, NUL-padded
+ *         uint32_t offset      from the start of the blob, word-aligned
+ *         uint32_t size
+ *     entry data
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <cstring>
+
+constexpr uint32_t IMAGE_BLOB_VERSION = 1;
+
+class ImageBlob {
+public:
+    static constexpr int HEADER = 16;
+    static constexpr int ENTRY = 32;
+    static constexpr int NAME = 24;
+
+    // Use the blob mapped at base, which is valid for size bytes. False,
+    // leaving no entries, if there is no well-formed blob there.
+    bool open(const uint8_t* base, uint32_t size) {
+        entries = 0;
+        if (size < HEADER || memcmp(base, "TBLB", 4) != 0 || read32(base + 4) != IMAGE_BLOB_VERSION) return false;
+        uint32_t n = read32(base + 8), bytes = read32(base + 12);
+        if (bytes > size || n > (bytes - HEADER) / ENTRY) return false;
+        for (uint32_t i = 0; i < n; i++) {
+            const uint8_t* e = base + HEADER + i * ENTRY;
+            uint32_t offset = read32(e + NAME), length = read32(e + NAME + 4);
+            if (e[NAME - 1] != '\0' || offset > bytes || length > bytes - offset) return false;
+        }
+        blob = base;
+        entries = (int)n;
+        return true;
+    }
+
+    int count() const { return entries; }
+    const char* name(int i) const { return (const char*)entry(i); }
+    const uint8_t* data(int i) const { return blob + read32(entry(i) + NAME); }
+    uint32_t size(int i) const { return read32(entry(i) + NAME + 4); }
+
+    // Index of the entry called name, or -1
+    int find(const char* name) const {
+        for (int i = 0; i < entries; i++) {
+            if (strcmp(this->name(i), name) == 0) return i;
+        }
+        return -1;
+    }
+
+private:
+    static uint32_t read32(const uint8_t* p) {
+        return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+    }
+
+    const uint8_t* entry(int i) const { return blob + HEADER + i * ENTRY; }
+
+    const uint8_t* blob = nullptr;
+    int entries = 0;
+};
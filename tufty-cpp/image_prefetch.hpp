@@ -0,0 +1,208 @@
+/**
+ * Tufty 2040 Badge - background image prefetch
+ *
+ * While the slideshow shows one image, the Worker (core1 on the device)
+ * decodes the next one, so moving on costs an expansion into the
+ * framebuffer instead of a filesystem read and a PNG decode with the LED
+ * on. A second 150 KB framebuffer does not fit next to the first, so the
+ * decoded rows are staged run-length coded in a STAGING-byte buffer: the
+ * badge's flat-colour images shrink to a few KB. An image that does not
+ * fit, or fails to decode, is dropped and loaded the usual way when its
+ * turn comes.
+ *
+ * The decoding is the caller's: decode(index, stage, ctx) runs on the
+ * worker and hands over the image's rows in order with stage.row(). It
+ * must not share anything with the caller's side (the PNG decoder, the
+ * filesystem) until take() or cancel() has returned.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <cstring>
+#include <atomic>
+#include "concurrency.hpp"
+
+enum class PrefetchState : uint8_t {
+    Idle,      // Nothing requested, or taken/cancelled
+    Loading,   // The worker is decoding
+    Ready,     // Decoded and staged
+    Failed     // Did not decode or did not fit
+};
+
+// Run-length coded rows of W big-endian RGB565 pixels in WORDS words. Each
+// control word is followed by one pixel repeated (c & 0x7FFF) times when
+// its top bit is set, else by c literal pixels.
+template <int W, int WORDS>
+class ImageStage {
+public:
+    void reset() {
+        used = 0;
+        rows = 0;
+        overflow = false;
+    }
+
+    // Stage row y of the image. Rows come in order from 0; false once the
+    // staging buffer is full or the prefetch was cancelled, and for every
+    // row after that. A decoder that cannot stop early, as PNGdec cannot
+    // from its draw callback, runs on to the end with its rows dropped.
+    bool row(int y, const uint16_t* px, int width) {
+        if (overflow || y != rows || width != W || (cancel && cancel->load(std::memory_order_relaxed))) {
+            overflow = true;
+            return false;
+        }
+        int x = 0, literal = 0;
+        while (x < W) {
+            int run = 1;
+            while (x + run < W && px[x + run] == px[x] && run < 0x7FFF) run++;
+            if (run < 3) {
+                x += run;
+                literal += run;
+                continue;
+            }
+            if (literal && !emit_literal(px + x - literal, literal)) return false;
+            literal = 0;
+            if (!put(0x8000 | run) || !put(px[x])) return false;
+            x += run;
+        }
+        if (literal && !emit_literal(px + W - literal, literal)) return false;
+        rows++;
+        return true;
+    }
+
+    // Every one of h rows staged
+    bool complete(int h) const { return !overflow && rows == h; }
+
+    int bytes() const { return used * 2; }
+
+    // Expand the staged rows into the W-wide framebuffer fb
+    void take(uint16_t* fb) const {
+        uint16_t* out = fb;
+        const uint16_t* p = words;
+        const uint16_t* end = words + used;
+        while (p < end) {
+            uint16_t c = *p++;
+            int n = c & 0x7FFF;
+            if (c & 0x8000) {
+                uint16_t colour = *p++;
+                for (int i = 0; i < n; i++) out[i] = colour;
+            } else {
+                memcpy(out, p, n * 2);
+                p += n;
+            }
+            out += n;
+        }
+    }
+
+    const std::atomic<bool>* cancel = nullptr;
+
+private:
+    bool put(uint16_t w) {
+        if (used == WORDS) {
+            overflow = true;
+            return false;
+        }
+        words[used++] = w;
+        return true;
+    }
+
+    bool emit_literal(const uint16_t* px, int n) {
+        if (used + 1 + n > WORDS) {
+            overflow = true;
+            return false;
+        }
+        words[used++] = (uint16_t)n;
+        memcpy(&words[used], px, n * 2);
+        used += n;
+        return true;
+    }
+
+    uint16_t words[WORDS];
+    int used = 0, rows = 0;
+    bool overflow = false;
+};
+
+// Stage is where rows are decoded to, an ImageStage of some size. It has
+// reset(), row(), complete(h), bytes() and take(fb), which expands the
+// staged image into the framebuffer fb.
+template <int W, int H, typename Stage>
+class ImagePrefetcher {
+public:
+    using Decode = bool (*)(int index, Stage& stage, void* ctx);
+
+    ImagePrefetcher(Decode decode, void* ctx) : decode(decode), ctx(ctx) { stage.cancel = &cancelling; }
+
+    // Start decoding image index on the worker, dropping any earlier
+    // prefetch. The stage is separate from the framebuffer, so this may be
+    // called while the framebuffer is on its way to the display.
+    void request(int index) {
+        cancel();
+        pending = index;
+        cancelling.store(false, std::memory_order_relaxed);
+        status.store(PrefetchState::Loading, std::memory_order_release);
+        worker.start(worker_entry, this);
+        started = true;
+    }
+
+    PrefetchState state() const { return status.load(std::memory_order_acquire); }
+
+    // Image being prefetched, or -1
+    int index() const { return pending; }
+
+    // Staged size of the last prefetch, in bytes, once taken or cancelled
+    int staged_bytes() const { return stage.bytes(); }
+
+    // If image index is the one requested, wait for the worker to finish
+    // with it and expand it into fb (W x H pixels): true. Otherwise, or if
+    // it failed, false with the worker stopped, for the caller to load the
+    // image itself.
+    bool take(int index, uint16_t* fb) {
+        if (index != pending) {
+            cancel();
+            return false;
+        }
+        finish();
+        bool ready = state() == PrefetchState::Ready;
+        if (ready) stage.take(fb);
+        status.store(PrefetchState::Idle, std::memory_order_relaxed);
+        pending = -1;
+        return ready;
+    }
+
+    // Abandon any prefetch and stop the worker, e.g. before the caller uses
+    // the decoder or the other core. Rows decoded from here on are not
+    // staged, but the worker is waited for: with PNGdec that is the rest
+    // of the decode.
+    void cancel() {
+        cancelling.store(true, std::memory_order_relaxed);
+        finish();
+        status.store(PrefetchState::Idle, std::memory_order_relaxed);
+        pending = -1;
+    }
+
+private:
+    void finish() {
+        if (!started) return;
+        worker.join();
+        started = false;
+    }
+
+    static void worker_entry(void* self) {
+        static_cast<ImagePrefetcher*>(self)->produce();
+    }
+
+    void produce() {
+        stage.reset();
+        bool ok = decode(pending, stage, ctx) && stage.complete(H);
+        status.store(ok ? PrefetchState::Ready : PrefetchState::Failed, std::memory_order_release);
+    }
+
+    Decode decode;
+    void* ctx;
+    Worker worker;
+    Stage stage;
+    std::atomic<PrefetchState> status{PrefetchState::Idle};
+    std::atomic<bool> cancelling{false};
+    int pending = -1;
+    bool started = false;
+};
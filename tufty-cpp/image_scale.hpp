@@ -0,0 +1,136 @@
+/**
+ * Tufty 2040 Badge - fitting images of any size to the screen
+ *
+ * Images arrive a row at a time from the PNG decoder and are never held
+ * whole. One that fits is centred at 1:1. A larger one is scaled down,
+ * keeping its aspect ratio, by a 16.16 fixed-point step the same in both
+ * directions, and centred:
+ *
+ * - Nearest takes the source pixel under the centre of each screen pixel.
+ * - Box averages the 2x2 source pixels around that centre, which is the
+ *   exact box filter at 2:1 and smooths out the aliasing of nearest at
+ *   other ratios. It keeps the previous source row for the top pair.
+ *
+ * Pixels are big-endian RGB565 in and out, as the framebuffer holds them.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <cstring>
+
+enum class ScaleFilter : uint8_t {
+    Nearest,
+    Box
+};
+
+// DW x DH framebuffer, source images up to MAX_W pixels wide
+template <int DW, int DH, int MAX_W>
+class ImageScaler {
+public:
+    // Place an sw x sh image on the screen; false if it is empty or wider
+    // than MAX_W
+    bool begin(int sw, int sh, ScaleFilter f) {
+        if (sw < 1 || sh < 1 || sw > MAX_W) return false;
+        src_w = sw;
+        src_h = sh;
+        filter = f;
+        step = 1 << 16;
+        if (sw > DW || sh > DH) {
+            uint64_t sx = ((uint64_t)sw << 16) / DW;
+            uint64_t sy = ((uint64_t)sh << 16) / DH;
+            step = sx > sy ? sx : sy;
+        }
+        out_w = (int)(((uint64_t)sw << 16) / step);
+        out_h = (int)(((uint64_t)sh << 16) / step);
+        out_w = out_w < 1 ? 1 : out_w > DW ? DW : out_w;
+        out_h = out_h < 1 ? 1 : out_h > DH ? DH : out_h;
+        out_x = (DW - out_w) / 2;
+        out_y = (DH - out_h) / 2;
+        for (int x = 0; x < out_w; x++) column[x] = (uint16_t)first(x, sw);
+        next_row = 0;
+        return true;
+    }
+
+    // Where the image lands on the screen
+    int x() const { return out_x; }
+    int y() const { return out_y; }
+    int width() const { return out_w; }
+    int height() const { return out_h; }
+    bool scaled() const { return step != 1 << 16; }
+
+    // Room for one source row, for the decoder to convert into
+    uint16_t* line() { return current; }
+
+    // Fill the screen around the image with colour
+    void clear_border(uint16_t* fb, uint16_t colour) const {
+        for (int y = 0; y < DH; y++) {
+            uint16_t* row = fb + y * DW;
+            if (y < out_y || y >= out_y + out_h) {
+                for (int x = 0; x < DW; x++) row[x] = colour;
+                continue;
+            }
+            for (int x = 0; x < out_x; x++) row[x] = colour;
+            for (int x = out_x + out_w; x < DW; x++) row[x] = colour;
+        }
+    }
+
+    // Source row y, in order from the top; writes the screen rows it
+    // completes into fb
+    void row(int y, const uint16_t* px, uint16_t* fb) {
+        if (!scaled()) {
+            if (y >= out_h) return;
+            memcpy(fb + (out_y + y) * DW + out_x, px, out_w * 2);
+            return;
+        }
+        while (next_row < out_h) {
+            int top = first(next_row, src_h);
+            int bottom = filter == ScaleFilter::Box && top + 1 < src_h ? top + 1 : top;
+            if (bottom > y) break;
+            uint16_t* out = fb + (out_y + next_row) * DW + out_x;
+            if (filter == ScaleFilter::Nearest) {
+                for (int x = 0; x < out_w; x++) out[x] = px[column[x]];
+            } else {
+                box(top == y ? px : previous, px, out);
+            }
+            next_row++;
+        }
+        if (filter == ScaleFilter::Box) memcpy(previous, px, src_w * 2);
+    }
+
+private:
+    // First source pixel sampled for output pixel i along an axis of n:
+    // the one under the centre for nearest, the left or top of the pair
+    // around it for box
+    int first(int i, int n) const {
+        uint64_t centre = (uint64_t)i * step + step / 2;
+        uint64_t p = filter == ScaleFilter::Nearest ? centre >> 16 : centre < 0x8000 ? 0 : (centre - 0x8000) >> 16;
+        return p < (uint64_t)n - 1 ? (int)p : n - 1;
+    }
+
+    // RGB565 spread out with gaps between the channels, so four pixels
+    // can be summed in one word: green in bits 21-26, red 11-15, blue 0-4
+    static uint32_t spread(uint16_t be) {
+        uint32_t c = (uint16_t)((be >> 8) | (be << 8));
+        return (c | c << 16) & 0x07E0F81F;
+    }
+
+    void box(const uint16_t* top, const uint16_t* bottom, uint16_t* out) const {
+        for (int x = 0; x < out_w; x++) {
+            int a = column[x], b = a + 1 < src_w ? a + 1 : a;
+            uint32_t sum = spread(top[a]) + spread(top[b]) + spread(bottom[a]) + spread(bottom[b]);
+            uint32_t c = ((sum + 0x00401002) >> 2) & 0x07E0F81F;
+            c |= c >> 16;
+            out[x] = (uint16_t)((c >> 8 & 0xFF) | (c << 8));
+        }
+    }
+
+    uint16_t current[MAX_W];
+    uint16_t previous[MAX_W];
+    uint16_t column[DW];
+    uint64_t step = 1 << 16;
+    int src_w = 0, src_h = 0;
+    int out_x = 0, out_y = 0, out_w = 0, out_h = 0;
+    int next_row = 0;
+    ScaleFilter filter = ScaleFilter::Nearest;
+};
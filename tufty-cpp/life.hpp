@@ -0,0 +1,810 @@
+/**
+ * Tufty 2040 Badge - Game of Life engine
+ *
+ * Bit-sliced kernel: cells are packed 32 per uint32_t, row-major, bit 0
+ * of a word being its leftmost cell. Neighbour sums are computed for 32
+ * cells at once with full-adder logic instead of eight loads per cell.
+ * The kernel is a template parameter, and so is the rule it applies (B/S
+ * notation, see LifeRule); see life_lut.hpp for a lookup-table alternative.
+ *
+ * The grid is split into tiles one word wide and LIFE_TILE_ROWS tall. A
+ * tile is only recomputed when it or one of its eight neighbours changed
+ * in the last generation, so boards that have settled into still lifes
+ * cost almost nothing per step.
+ *
+ * On a thinned-out board the pass over every tile's flags and the eight
+ * rows of each active tile outweigh the few cells that change, so below
+ * one alive cell in LIFE_SPARSE_DENSITY the grid is stepped sparsely: a
+ * list of the words that changed says which words to compute, with the
+ * same kernel. Both paths leave identical planes and flags, so the
+ * engine switches between them freely as the population changes.
+ *
+ * Each generation also carries a 64-bit hash, a keyed sum over its
+ * storage words, and LifeStats: population, births, deaths and the box
+ * around the cells that changed. Both are updated from the words the
+ * kernel rewrites, while it has them in hand, so neither costs anything
+ * on settled tiles; see life_cycle.hpp for using the hash to spot
+ * oscillating boards.
+ *
+ * Storage is row-major by default, matching the framebuffer's scanline
+ * order so changed cells are emitted (and drawn) top to bottom. A
+ * column-major layout is kept for comparison: outer-totalistic rules are
+ * symmetric under transposition, so it is the same kernel run on the transposed grid.
+ *
+ * Header-only and free of Pico SDK dependencies so it also builds on the
+ * host (see bench/).
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <cstring>
+#include <type_traits>
+
+// Cell states as seen by the renderer
+constexpr uint8_t LIFE_DEAD  = 0;
+constexpr uint8_t LIFE_ALIVE = 1;
+constexpr uint8_t LIFE_DYING = 2;  // Died this generation, drawn red
+
+// Tile height in rows; tiles are one 32-cell word wide
+constexpr int LIFE_TILE_ROWS = 8;
+
+// Grids with at most one alive cell in this many are stepped sparsely by
+// default, and a sparse step computes at most this many words, else it
+// falls back to the dense path. Without LifeStats the population that
+// switches to sparse stepping is recounted every LIFE_SPARSE_RECOUNT
+// dense steps.
+constexpr int LIFE_SPARSE_DENSITY = 50;
+constexpr int LIFE_SPARSE_WORDS = 512;
+constexpr int LIFE_SPARSE_RECOUNT = 16;
+
+// Steps needing more than this percentage of the tiles compute them all
+constexpr int LIFE_DENSE_PERCENT = 75;
+
+// Board hash: the sum over storage words of the square of the word
+// XORed with a per-word key. Being a sum, it follows a changed word with
+// two squares; squaring keeps it from being linear in the word, so
+// changes in a word's high bits reach the whole hash too. Each square is a
+// 64-bit product: one multiply instruction on the host, but the Cortex-M0+
+// only multiplies 32x32->32, so there it is a library call building the
+// product from 16-bit halves with several multiplies. The Life timing
+// printout measures what an update costs on the device.
+struct LifeHash {
+    uint64_t sum = 0;
+
+    static uint64_t term(uint32_t word, uint32_t index) {
+        uint64_t x = word ^ (index * 0x9E3779B9u) ^ 0x7F4A7C15u;
+        return x * x;
+    }
+
+    // Word number index changed from old to word. Sums start from the
+    // empty grid, so a grid with no live cells hashes to 0.
+    void update(uint32_t old, uint32_t word, uint32_t index) { sum += term(word, index) - term(old, index); }
+
+    uint64_t value() const { return sum; }
+};
+
+// Bits set in x. Neither the host build nor the Cortex-M0+ has a popcount
+// instruction, and __builtin_popcount() becomes a library call; this
+// inlines to a dozen operations and one (single-cycle) multiply.
+inline uint32_t life_popcount(uint32_t x) {
+    x -= (x >> 1) & 0x55555555u;
+    x = (x & 0x33333333u) + ((x >> 2) & 0x33333333u);
+    x = (x + (x >> 4)) & 0x0F0F0F0Fu;
+    return (x * 0x01010101u) >> 24;
+}
+
+// Births and deaths summed over many words. Each word's bits are added
+// up into 16-bit lanes, births in the upper half of a 64-bit accumulator
+// and deaths in the lower, which hold the counts of 4095 words before
+// they have to be summed: a dozen operations a word instead of two
+// popcounts.
+struct LifeFlipTally {
+    static constexpr int WORDS_MAX = 4095;
+
+    uint64_t lanes = 0;
+
+    void add(uint32_t born, uint32_t died) {
+        uint64_t x = (uint64_t)born << 32 | died;
+        x -= (x >> 1) & 0x5555555555555555ull;
+        x = (x & 0x3333333333333333ull) + ((x >> 2) & 0x3333333333333333ull);
+        x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+        lanes += (x + (x >> 8)) & 0x00FF00FF00FF00FFull;
+    }
+
+    // Move the lanes' counts to births and deaths
+    void flush(uint32_t& births, uint32_t& deaths) {
+        births += (uint32_t)(lanes >> 48) + ((uint32_t)(lanes >> 32) & 0xFFFF);
+        deaths += ((uint32_t)lanes >> 16) + ((uint32_t)lanes & 0xFFFF);
+        lanes = 0;
+    }
+};
+
+// Counters kept by BitLife as it steps
+struct LifeStats {
+    uint32_t population;       // Alive cells
+    uint32_t births, deaths;   // In the last generation
+    // Inclusive bounding box of the cells that changed in the last
+    // generation; x0 > x1 when none did
+    int16_t x0, y0, x1, y1;
+};
+
+// Order cells are packed and emitted in
+enum class LifeLayout {
+    RowMajor,     // 32 horizontally adjacent cells per word
+    ColumnMajor   // 32 vertically adjacent cells per word
+};
+
+// Outer-totalistic rule in B/S notation: bit n of BIRTH (SURVIVE) set
+// means a dead (alive) cell with n alive neighbours is alive next. Rules
+// are types so each one compiles to its own kernel with the masks folded
+// in; B0 rules would light up the empty plane and are not supported.
+template <uint16_t BIRTH_MASK, uint16_t SURVIVE_MASK>
+struct LifeRule {
+    static constexpr uint16_t BIRTH = BIRTH_MASK;
+    static constexpr uint16_t SURVIVE = SURVIVE_MASK;
+
+    static_assert(!(BIRTH & 1), "B0 rules are not supported");
+    static_assert(BIRTH < (1 << 9) && SURVIVE < (1 << 9), "at most eight neighbours");
+};
+
+struct ConwayRule : LifeRule<1 << 3, (1 << 2) | (1 << 3)> {
+    static constexpr const char* NAME = "Conway B3/S23";
+};
+
+struct HighLifeRule : LifeRule<(1 << 3) | (1 << 6), (1 << 2) | (1 << 3)> {
+    static constexpr const char* NAME = "HighLife B36/S23";
+};
+
+struct DayNightRule : LifeRule<(1 << 3) | (1 << 6) | (1 << 7) | (1 << 8),
+                               (1 << 3) | (1 << 4) | (1 << 6) | (1 << 7) | (1 << 8)> {
+    static constexpr const char* NAME = "Day & Night B3678/S34678";
+};
+
+struct SeedsRule : LifeRule<1 << 2, 0> {
+    static constexpr const char* NAME = "Seeds B2/S";
+};
+
+struct MorleyRule : LifeRule<(1 << 3) | (1 << 6) | (1 << 8), (1 << 2) | (1 << 4) | (1 << 5)> {
+    static constexpr const char* NAME = "Morley B368/S245";
+};
+
+// Generation kernels compute the next state of one storage word (32
+// cells) from the rows around it. ROWS is how many rows one call yields.
+
+// Bit-sliced adders over the eight neighbour words
+template <typename Rule = ConwayRule>
+struct SwarKernel {
+    static constexpr int ROWS = 1;
+
+    // Neighbour to the west (x - 1) of every cell in word k
+    template <int WORDS>
+    static inline uint32_t west(const uint32_t* r, int k) {
+        return (r[k] << 1) | (k > 0 ? r[k - 1] >> 31 : 0);
+    }
+
+    // Neighbour to the east (x + 1) of every cell in word k
+    template <int WORDS>
+    static inline uint32_t east(const uint32_t* r, int k) {
+        return (r[k] >> 1) | (k + 1 < WORDS ? r[k + 1] << 31 : 0);
+    }
+
+    // Cells of word k whose neighbour count (bits s8 s4 s2 s1) has its
+    // bit set in MASK; with MASK a constant this unrolls to a few ANDs
+    template <uint16_t MASK>
+    static inline uint32_t count_in(uint32_t s1, uint32_t s2, uint32_t s4, uint32_t s8) {
+        uint32_t r = 0;
+        for (int n = 0; n <= 8; n++) {
+            if (!((MASK >> n) & 1)) continue;
+            r |= (n & 1 ? s1 : ~s1) & (n & 2 ? s2 : ~s2) & (n & 4 ? s4 : ~s4) & (n & 8 ? s8 : ~s8);
+        }
+        return r;
+    }
+
+    // Rule for the 32 cells of word k, using bit-parallel adders
+    template <int WORDS>
+    static inline uint32_t next_word(const uint32_t* up, const uint32_t* mid, const uint32_t* dn, int k) {
+        uint32_t a = west<WORDS>(up, k), b = up[k], c = east<WORDS>(up, k);
+        uint32_t up0 = a ^ b ^ c;
+        uint32_t up1 = (a & b) | (c & (a ^ b));
+
+        uint32_t d = west<WORDS>(mid, k), e = east<WORDS>(mid, k);
+        uint32_t mid0 = d ^ e;
+        uint32_t mid1 = d & e;
+
+        a = west<WORDS>(dn, k); b = dn[k]; c = east<WORDS>(dn, k);
+        uint32_t dn0 = a ^ b ^ c;
+        uint32_t dn1 = (a & b) | (c & (a ^ b));
+
+        // Ones column: bit 0 of the sum, carry into the twos column
+        uint32_t ones = up0 ^ mid0 ^ dn0;
+        uint32_t carry = (up0 & mid0) | (dn0 & (up0 ^ mid0));
+
+        // Twos column: four weight-2 inputs
+        uint32_t p = up1 ^ mid1 ^ dn1;
+        uint32_t q = (up1 & mid1) | (dn1 & (up1 ^ mid1));
+        uint32_t twos = p ^ carry;
+
+        if constexpr (Rule::BIRTH == ConwayRule::BIRTH && Rule::SURVIVE == ConwayRule::SURVIVE) {
+            // B3/S23 only asks whether the sum is 2 or 3: exactly one
+            // weight-2 input set, so the fours and eights collapse
+            uint32_t fours = q | (p & carry);
+            uint32_t two_or_three = twos & ~fours;
+            return two_or_three & (ones | mid[k]);
+        } else {
+            uint32_t fours = q ^ (p & carry);
+            uint32_t eights = q & p & carry;
+            uint32_t born = count_in<Rule::BIRTH>(ones, twos, fours, eights);
+            uint32_t survives = count_in<Rule::SURVIVE>(ones, twos, fours, eights);
+            return (born & ~mid[k]) | (survives & mid[k]);
+        }
+    }
+};
+
+template <int W, int H, LifeLayout L = LifeLayout::RowMajor, typename Kernel = SwarKernel<>>
+class BitLife {
+public:
+    static constexpr int WIDTH = W;
+    static constexpr int HEIGHT = H;
+    static constexpr LifeLayout LAYOUT = L;
+
+    // Storage dimensions: the grid transposed for column-major
+    static constexpr int SW = L == LifeLayout::RowMajor ? W : H;
+    static constexpr int SH = L == LifeLayout::RowMajor ? H : W;
+
+    static constexpr int WORDS = (SW + 31) / 32;
+    static constexpr int TILES_X = WORDS;
+    static constexpr int TILES_Y = (SH + LIFE_TILE_ROWS - 1) / LIFE_TILE_ROWS;
+    static constexpr int TILE_COUNT = TILES_X * TILES_Y;
+
+    static_assert(W >= 3 && H >= 3, "grid needs an interior");
+
+    // One generation's alive cells, in storage order
+    using Plane = uint32_t[SH][WORDS];
+
+    void clear() {
+        memset(planes, 0, sizeof(planes));
+        memset(changed, 0, sizeof(changed));
+        memset(changed_before, 0, sizeof(changed_before));
+        older = 0;
+        prev = 1;
+        cur = 2;
+        active = 0;
+        hashed = 0;
+        board_hash = LifeHash();
+        population = 0;
+        stale_steps = 0;
+        births = deaths = 0;
+        box_x0 = box_y0 = INT16_MAX;
+        box_x1 = box_y1 = -1;
+        flips_valid = false;
+        sparse = false;
+    }
+
+    // Seed a cell in the current generation
+    void set(int x, int y) {
+        int sx = storage_x(x, y), sy = storage_y(x, y);
+        uint32_t& word = planes[cur][sy][sx >> 5];
+        uint32_t old = word;
+        word |= 1u << (sx & 31);
+        board_hash.update(old, word, sy * WORDS + (sx >> 5));
+        population += word != old;
+        changed[sy / LIFE_TILE_ROWS][sx >> 5] = 1;
+        flips_valid = false;
+    }
+
+    // Recompute every tile each step (for benchmarking the tile tracking)
+    void set_skip_stable(bool skip) { skip_stable = skip; }
+
+    // Stop counting LifeStats in dense steps, leaving them stale (for
+    // benchmarking what they cost). Sparse steps still count them, and
+    // the population they switch on is recounted every
+    // LIFE_SPARSE_RECOUNT dense steps instead.
+    void set_track_stats(bool track) {
+        if (track && !track_stats) recount_population();
+        track_stats = track;
+    }
+
+    // Step sparsely while the population is at most `population` cells;
+    // 0 always steps densely. Needs stable-tile skipping.
+    void set_sparse_limit(uint32_t limit) {
+        if (!track_stats) recount_population();
+        sparse_limit = limit;
+    }
+
+    // Whether the last step() was sparse
+    bool sparse_active() const { return sparse; }
+
+    // Tiles recomputed by the last step()
+    int active_tiles() const { return active; }
+
+    // Storage words the last step() rewrote, each one a board hash update
+    int hashed_words() const { return hashed; }
+
+    // Hash of the current generation's alive cells, equal for equal boards
+    uint64_t hash() const { return board_hash.value(); }
+
+    LifeStats stats() const {
+        LifeStats s = {population, births, deaths, 0, 0, 0, 0};
+        if (box_x1 < 0) {
+            s.x0 = s.y0 = 0;
+            s.x1 = s.y1 = -1;
+        } else if (L == LifeLayout::RowMajor) {
+            s.x0 = box_x0, s.y0 = box_y0, s.x1 = box_x1, s.y1 = box_y1;
+        } else {
+            s.x0 = box_y0, s.y0 = box_x0, s.x1 = box_y1, s.y1 = box_x1;
+        }
+        return s;
+    }
+
+    bool alive(int x, int y) const {
+        return bit(cur, x, y);
+    }
+
+    // Alive, dying (alive last generation) or dead
+    uint8_t state(int x, int y) const {
+        if (bit(cur, x, y)) return LIFE_ALIVE;
+        if (bit(prev, x, y)) return LIFE_DYING;
+        return LIFE_DEAD;
+    }
+
+    // Advance one generation. The outermost ring of cells stays dead,
+    // matching the original byte-per-cell kernel.
+    void step() {
+        step([](int, int, uint8_t) {});
+    }
+
+    // Advance one generation and call emit(x, y, state) for every cell
+    // whose drawn state changed, in the same pass over the grid
+    template <typename Emit>
+    void step(Emit&& emit) {
+        step_with<Kernel>(emit);
+    }
+
+    // step() with another kernel, e.g. one compiled for a different rule
+    template <typename K, typename Emit>
+    void step_with(Emit&& emit) {
+        int next = older;
+        older = prev;
+        prev = cur;
+        cur = next;
+
+        const uint32_t (*a2)[WORDS] = planes[older];
+        const uint32_t (*src)[WORDS] = planes[prev];
+        uint32_t (*dst)[WORDS] = planes[cur];
+
+        // Without LifeStats the population may be some dense steps old:
+        // count it before switching on it
+        if (stale_steps && want_sparse()) recount_population();
+        if (want_sparse() && sparse_step<K>(a2, src, dst, emit)) return;
+        sparse = false;
+        flips_valid = false;
+
+        // A tile needs work if its neighbourhood changed last generation,
+        // or if it changed the generation before: then dst still holds
+        // stale cells and its dying cells have yet to be cleared. Any
+        // other tile is identical across all three planes already.
+        uint8_t work[TILES_Y][TILES_X];
+        bool row_work[TILES_Y];
+        bool every = !skip_stable;
+        if (skip_stable) {
+            // Spread each changed tile to its neighbours; visiting changed
+            // tiles only keeps this cheap on large, mostly quiet grids
+            memcpy(work, changed_before, sizeof(work));
+            for (int ty = 0; ty < TILES_Y; ty++) {
+                for (int tx = 0; tx < TILES_X; tx++) {
+                    if (!changed[ty][tx]) continue;
+                    for (int j = ty - 1; j <= ty + 1; j++) {
+                        for (int i = tx - 1; i <= tx + 1; i++) {
+                            if (j >= 0 && j < TILES_Y && i >= 0 && i < TILES_X) work[j][i] = 1;
+                        }
+                    }
+                }
+            }
+            int busy = 0;
+            for (int ty = 0; ty < TILES_Y; ty++) {
+                row_work[ty] = false;
+                for (int tx = 0; tx < TILES_X; tx++) {
+                    row_work[ty] |= work[ty][tx];
+                    busy += work[ty][tx];
+                }
+            }
+            // With most tiles busy, skipping the odd idle one saves less
+            // than the per-tile checks cost (tile_bench had 10-35% soups
+            // at x0.85-0.93 of every-tile stepping), so step them all
+            every = busy * 100 > TILE_COUNT * LIFE_DENSE_PERCENT;
+        }
+        if (every) {
+            memset(work, 1, sizeof(work));
+            memset(row_work, 1, sizeof(row_work));
+        }
+        memcpy(changed_before, changed, sizeof(changed));
+        int rewrites = 0;
+        StepTally tally;
+        LifeFlipTally flips;
+        bool count = track_stats;
+
+        // The outermost rows are never computed and stay dead
+        active = 0;
+        for (int ty = 0; ty < TILES_Y; ty++) {
+            // Skip idle tile rows outright, so a large quiet universe
+            // costs little more than its active area
+            if (!row_work[ty]) {
+                memset(changed[ty], 0, sizeof(changed[ty]));
+                continue;
+            }
+            int y0 = ty * LIFE_TILE_ROWS;
+            int y1 = y0 + LIFE_TILE_ROWS;
+            if (y0 < 1) y0 = 1;
+            if (y1 > SH - 1) y1 = SH - 1;
+
+            uint32_t diff[TILES_X] = {};
+            for (int y = y0; y < y1; y += K::ROWS) {
+                // A two-row kernel may overhang the tile; the extra row is
+                // computed from valid memory but not stored
+                bool pair = K::ROWS == 2 && y + 1 < y1;
+                bool row0 = false, row1 = false;
+                for (int k = 0; k < TILES_X; k++) {
+                    if (!every && !work[ty][k]) continue;
+                    uint32_t w0, w1 = 0;
+                    if constexpr (K::ROWS == 2) {
+                        K::template next_rows<WORDS>(src[y - 1], src[y], src[y + 1], src[pair ? y + 2 : y + 1], k, w0, w1);
+                    } else {
+                        w0 = K::template next_word<WORDS>(src[y - 1], src[y], src[y + 1], k);
+                    }
+                    w0 &= interior.m[k];
+                    dst[y][k] = w0;
+                    if (w0 != src[y][k]) {
+                        uint32_t was = src[y][k];
+                        diff[k] |= w0 ^ was;
+                        board_hash.update(was, w0, y * WORDS + k);
+                        rewrites++;
+                        row0 = true;
+                        if (count) flips.add(w0 & ~was, was & ~w0);
+                    }
+                    emit_changes(k, y, a2[y][k], src[y][k], w0, emit);
+                    if (pair) {
+                        w1 &= interior.m[k];
+                        dst[y + 1][k] = w1;
+                        if (w1 != src[y + 1][k]) {
+                            uint32_t was = src[y + 1][k];
+                            diff[k] |= w1 ^ was;
+                            board_hash.update(was, w1, (y + 1) * WORDS + k);
+                            rewrites++;
+                            row1 = true;
+                            if (count) flips.add(w1 & ~was, was & ~w1);
+                        }
+                        emit_changes(k, y + 1, a2[y + 1][k], src[y + 1][k], w1, emit);
+                    }
+                }
+                if (row0) tally.add_row(y);
+                if (row1) tally.add_row(y + 1);
+            }
+            for (int k = 0; k < TILES_X; k++) {
+                active += work[ty][k];
+                changed[ty][k] = diff[k] != 0;
+            }
+            if (count) {
+                flips.flush(tally.births, tally.deaths);
+                for (int k = 0; k < WORDS; k++) tally.columns[k] |= diff[k];
+            }
+        }
+        hashed = rewrites;
+        if (count) {
+            settle(tally);
+        } else if (sparse_limit && ++stale_steps >= LIFE_SPARSE_RECOUNT) {
+            recount_population();
+        }
+    }
+
+    // Call emit(x, y, state) for every cell whose drawn state differs
+    // between the previous generation and the current one
+    template <typename Emit>
+    void for_each_change(Emit&& emit) const {
+        diff(planes[older], planes[prev], planes[cur], emit);
+    }
+
+    // Copy the current generation out, e.g. to hand it to another core
+    void snapshot(Plane& out) const {
+        memcpy(out, planes[cur], sizeof(Plane));
+    }
+
+    // Copy the VW x VH window at (x0, y0) of the current generation out,
+    // packed as a BitLife<VW, VH> plane. The window must lie in the grid.
+    // A smaller w x h window may be cut instead; the rest of out is left
+    // as it was.
+    template <int VW, int VH>
+    void snapshot_window(int x0, int y0, uint32_t (&out)[VH][(VW + 31) / 32], int w = VW, int h = VH) const {
+        cut_window<VW, VH>(planes[cur], x0, y0, out, w, h);
+    }
+
+    // snapshot_window() of the previous generation, whose alive cells are
+    // the current one's dying cells
+    template <int VW, int VH>
+    void snapshot_previous_window(int x0, int y0, uint32_t (&out)[VH][(VW + 31) / 32], int w = VW,
+                                  int h = VH) const {
+        cut_window<VW, VH>(planes[prev], x0, y0, out, w, h);
+    }
+
+    // for_each_change() over three snapshots, oldest first, limited to the
+    // first rows x words of storage
+    template <typename Emit>
+    static void diff(const Plane& a2, const Plane& a1, const Plane& a0, Emit&& emit, int rows = SH,
+                     int words = WORDS) {
+        for (int y = 0; y < rows; y++) {
+            for (int k = 0; k < words; k++) {
+                emit_changes(k, y, a2[y][k], a1[y][k], a0[y][k], emit);
+            }
+        }
+    }
+
+private:
+    // Map between logical and storage coordinates; the swap is its own
+    // inverse, so the same helpers map back
+    static constexpr int storage_x(int x, int y) { return L == LifeLayout::RowMajor ? x : y; }
+    static constexpr int storage_y(int x, int y) { return L == LifeLayout::RowMajor ? y : x; }
+
+    // The snapshot_window() of one plane
+    template <int VW, int VH>
+    static void cut_window(const Plane& plane, int x0, int y0, uint32_t (&out)[VH][(VW + 31) / 32], int w, int h) {
+        static_assert(L == LifeLayout::RowMajor, "windows are cut from row-major storage");
+        int out_words = (w + 31) / 32;
+        uint32_t last = w % 32 ? (1u << (w % 32)) - 1 : ~0u;
+        int k0 = x0 >> 5, shift = x0 & 31;
+        for (int y = 0; y < h; y++) {
+            const uint32_t* r = plane[y0 + y];
+            for (int k = 0; k < out_words; k++) {
+                int j = k0 + k;
+                uint32_t word = j < WORDS ? r[j] >> shift : 0;
+                if (shift && j + 1 < WORDS) word |= r[j + 1] << (32 - shift);
+                out[y][k] = word;
+            }
+            out[y][out_words - 1] &= last;
+        }
+    }
+
+    // LifeStats gathered by a step: births and deaths, counted from the
+    // words it rewrites, and the rows and word columns where cells changed
+    struct StepTally {
+        static_assert(LIFE_TILE_ROWS * WORDS <= LifeFlipTally::WORDS_MAX &&
+                      LIFE_SPARSE_WORDS <= LifeFlipTally::WORDS_MAX, "tally lanes would overflow");
+
+        uint32_t births = 0, deaths = 0;
+        int y0 = SH, y1 = -1;
+        uint32_t columns[WORDS] = {};
+
+        void add_row(int y) {
+            if (y < y0) y0 = y;
+            y1 = y;
+        }
+    };
+
+    // Take the LifeStats of the step just taken from its tally
+    void settle(const StepTally& tally) {
+        births = tally.births;
+        deaths = tally.deaths;
+        population += births - deaths;
+        box_x0 = box_y0 = INT16_MAX;
+        box_x1 = box_y1 = -1;
+        if (tally.y1 < 0) return;
+        int k0 = 0, k1 = WORDS - 1;
+        while (!tally.columns[k0]) k0++;
+        while (!tally.columns[k1]) k1--;
+        box_x0 = (int16_t)(k0 * 32 + __builtin_ctz(tally.columns[k0]));
+        box_x1 = (int16_t)(k1 * 32 + 31 - __builtin_clz(tally.columns[k1]));
+        box_y0 = (int16_t)tally.y0;
+        box_y1 = (int16_t)tally.y1;
+    }
+
+    static constexpr int SPARSE_WORDS = SH * WORDS < LIFE_SPARSE_WORDS ? SH * WORDS : LIFE_SPARSE_WORDS;
+
+    // Storage words as row * WORDS + word, in ascending order
+    using WordIndex = std::conditional_t<SH * WORDS <= 65536, uint16_t, uint32_t>;
+    struct WordList {
+        WordIndex at[SPARSE_WORDS];
+        int count = 0;
+    };
+
+    void recount_population() {
+        stale_steps = 0;
+        population = 0;
+        for (int y = 0; y < SH; y++) {
+            for (int k = 0; k < WORDS; k++) population += life_popcount(planes[cur][y][k]);
+        }
+    }
+
+    bool want_sparse() const {
+        if (!sparse_limit || !skip_stable) return false;
+        // Some slack before leaving, so a population hovering at the limit
+        // does not flip between the paths every few steps
+        return population <= (sparse ? sparse_limit + sparse_limit / 4 : sparse_limit);
+    }
+
+    // Every word of the tiles flagged in `tiles`; false if too many
+    bool words_of(const uint8_t (*tiles)[TILES_X], WordList& list) {
+        list.count = 0;
+        for (int ty = 0; ty < TILES_Y; ty++) {
+            for (int k = 0; k < TILES_X; k++) {
+                if (!tiles[ty][k]) continue;
+                int y1 = ty * LIFE_TILE_ROWS + LIFE_TILE_ROWS < SH ? ty * LIFE_TILE_ROWS + LIFE_TILE_ROWS : SH;
+                if (list.count + (y1 - ty * LIFE_TILE_ROWS) > SPARSE_WORDS) return false;
+                for (int y = ty * LIFE_TILE_ROWS; y < y1; y++) list.at[list.count++] = (WordIndex)(y * WORDS + k);
+            }
+        }
+        return true;
+    }
+
+    // The tile-skipping step at word granularity, driven by lists of the
+    // words that changed instead of a pass over every tile: only words
+    // bordering a cell that changed last generation are computed, and
+    // words that changed the generation before are brought up to date in
+    // dst. Right after dense steps the lists are rebuilt from the tile
+    // flags. Returns false without touching the planes if a list would
+    // overflow.
+    template <typename K, typename Emit>
+    bool sparse_step(const uint32_t (*a2)[WORDS], const uint32_t (*src)[WORDS], uint32_t (*dst)[WORDS],
+                     Emit& emit) {
+        WordList& now = flips[flip];
+        WordList& before = flips[flip ^ 1];
+        if (!flips_valid && !(words_of(changed, now) && words_of(changed_before, before))) return false;
+        flips_valid = false;
+
+        // Candidates go in a bitmap over the storage words, which also
+        // puts them in order. Rebuilt lists hold whole tiles, so skip words
+        // with no changes; the outermost rows stay dead and are never
+        // candidates.
+        memset(candidates, 0, sizeof(candidates));
+        int n = 0;
+        for (int j = 0; j < now.count; j++) {
+            int y = now.at[j] / WORDS, k = now.at[j] % WORDS;
+            uint32_t d = src[y][k] ^ a2[y][k];
+            if (!d) continue;
+            int k0 = k > 0 && (d & 1) ? k - 1 : k;
+            int k1 = k + 1 < WORDS && (d >> 31) ? k + 1 : k;
+            for (int r = y - 1; r <= y + 1; r++) {
+                if (r < 1 || r > SH - 2) continue;
+                for (int c = k0; c <= k1; c++) {
+                    int i = r * WORDS + c;
+                    uint32_t bit = 1u << (i & 31);
+                    n += !(candidates[i >> 5] & bit);
+                    candidates[i >> 5] |= bit;
+                }
+            }
+        }
+        if (n > SPARSE_WORDS) return false;
+
+        // dst holds the generation before last, stale where it changed
+        for (int j = 0; j < before.count; j++) {
+            int y = before.at[j] / WORDS, k = before.at[j] % WORDS;
+            dst[y][k] = src[y][k];
+        }
+
+        memcpy(changed_before, changed, sizeof(changed));
+        memset(changed, 0, sizeof(changed));
+        uint8_t touched[TILES_Y][TILES_X] = {};
+        StepTally tally;
+        LifeFlipTally flips;
+        active = 0;
+        before.count = 0;
+        for (int m = 0; m < (SH * WORDS + 31) / 32; m++) {
+            for (uint32_t bits = candidates[m]; bits; bits &= bits - 1) {
+                int i = m * 32 + __builtin_ctz(bits);
+                int y = i / WORDS, k = i % WORDS;
+                uint32_t old = src[y][k], w0;
+                if constexpr (K::ROWS == 2) {
+                    uint32_t w1;
+                    K::template next_rows<WORDS>(src[y - 1], src[y], src[y + 1], src[y + 1], k, w0, w1);
+                } else {
+                    w0 = K::template next_word<WORDS>(src[y - 1], src[y], src[y + 1], k);
+                }
+                w0 &= interior.m[k];
+                dst[y][k] = w0;
+                if (w0 != old) {
+                    changed[y / LIFE_TILE_ROWS][k] = 1;
+                    before.at[before.count++] = (WordIndex)i;
+                    board_hash.update(old, w0, i);
+                    flips.add(w0 & ~old, old & ~w0);
+                    tally.columns[k] |= w0 ^ old;
+                    tally.add_row(y);
+                }
+                uint8_t& t = touched[y / LIFE_TILE_ROWS][k];
+                active += !t;
+                t = 1;
+                emit_changes(k, y, a2[y][k], old, w0, emit);
+            }
+        }
+        hashed = before.count;
+        flip ^= 1;
+        flips_valid = true;
+        sparse = true;
+        // Always counted: sparse steps are what the population switches
+        // between, and they rewrite few words
+        flips.flush(tally.births, tally.deaths);
+        settle(tally);
+        return true;
+    }
+
+    bool bit(int plane, int x, int y) const {
+        int sx = storage_x(x, y), sy = storage_y(x, y);
+        return (planes[plane][sy][sx >> 5] >> (sx & 31)) & 1;
+    }
+
+    // Diff one storage word across three generations (a2 oldest, a0 newest)
+    template <typename Emit>
+    static inline void emit_changes(int k, int y, uint32_t a2, uint32_t a1, uint32_t a0, Emit& emit) {
+        uint32_t dying_then = a2 & ~a1;
+        uint32_t dying_now = a1 & ~a0;
+        uint32_t changed = (a1 ^ a0) | (dying_then ^ dying_now);
+        while (changed) {
+            int b = __builtin_ctz(changed);
+            changed &= changed - 1;
+            uint32_t bit = 1u << b;
+            uint8_t s = (a0 & bit) ? LIFE_ALIVE : (a1 & bit) ? LIFE_DYING : LIFE_DEAD;
+            int sx = k * 32 + b;
+            emit(storage_x(sx, y), storage_y(sx, y), s);
+        }
+    }
+
+    // Bits for x in [1, SW - 2] within word k
+    static constexpr uint32_t interior_mask(int k) {
+        uint32_t m = 0;
+        for (int b = 0; b < 32; b++) {
+            int x = k * 32 + b;
+            if (x >= 1 && x <= SW - 2) m |= 1u << b;
+        }
+        return m;
+    }
+
+    struct InteriorMasks {
+        uint32_t m[WORDS];
+        constexpr InteriorMasks() : m() {
+            for (int k = 0; k < WORDS; k++) m[k] = interior_mask(k);
+        }
+    };
+    static constexpr InteriorMasks interior = InteriorMasks();
+
+    uint32_t planes[3][SH][WORDS] = {};
+    int older = 0, prev = 1, cur = 2;
+
+    // Per-tile "alive cells changed" for the last two steps
+    uint8_t changed[TILES_Y][TILES_X] = {};
+    uint8_t changed_before[TILES_Y][TILES_X] = {};
+    bool skip_stable = true;
+    int active = 0;
+    int hashed = 0;
+    LifeHash board_hash;
+
+    // LifeStats, with the box in storage coordinates, and the dense steps
+    // taken without them since the population was last counted
+    bool track_stats = true;
+    int stale_steps = 0;
+    uint32_t population = 0;
+    uint32_t births = 0, deaths = 0;
+    int16_t box_x0 = INT16_MAX, box_y0 = INT16_MAX, box_x1 = -1, box_y1 = -1;
+
+    // Sparse stepping: the words that changed in the last step and the
+    // one before (flips[flip] the last), and a bitmap of the words to
+    // compute
+    uint32_t sparse_limit = W * H / LIFE_SPARSE_DENSITY;
+    bool sparse = false;
+    WordList flips[2];
+    int flip = 0;
+    bool flips_valid = false;
+    uint32_t candidates[(SH * WORDS + 31) / 32];
+};
+
+// A compiled rule for runtime selection: step advances the grid one
+// generation with the kernel built for that rule
+template <typename Grid>
+struct LifeRuleEntry {
+    const char* name;
+    uint16_t birth;
+    uint16_t survive;
+    void (*step)(Grid&);
+};
+
+template <typename Grid, typename Rule, template <typename> class Kernel = SwarKernel>
+constexpr LifeRuleEntry<Grid> life_rule_entry() {
+    return {Rule::NAME, Rule::BIRTH, Rule::SURVIVE,
+            [](Grid& grid) { grid.template step_with<Kernel<Rule>>([](int, int, uint8_t) {}); }};
+}
@@ -0,0 +1,94 @@
+/**
+ * Tufty 2040 Badge - Game of Life cell ages
+ *
+ * How many generations each cell of the viewport has been alive, as a
+ * saturating 8-bit counter, for drawing live cells in heat-map colours
+ * (LIFE_HEAT_PALETTE) so long-lived structures stand out.
+ *
+ * Ages are kept for the viewport, not the universe: a byte per cell of a
+ * 320x240 universe would not fit next to the framebuffer, and aging the
+ * cells of settled tiles would stop BitLife from skipping them. They are
+ * advanced from the viewport's bit planes in the pass that finds the
+ * cells to redraw, in place of BitLife::diff(). Only words with births,
+ * deaths or cells still aging are visited, and a cell is only emitted
+ * when its colour changes, so a settled board draws nothing once its
+ * cells reach 255.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <cstring>
+#include "life_render.hpp"
+
+template <int W, int H>
+class LifeAge {
+public:
+    static constexpr int WIDTH = W;
+    static constexpr int HEIGHT = H;
+    static constexpr int WORDS = (W + 31) / 32;
+    static constexpr uint8_t MAX_AGE = 255;
+
+    void clear() {
+        memset(ages, 0, sizeof(ages));
+        memset(saturated, 0, sizeof(saturated));
+    }
+
+    // 0 for a dead cell, else generations alive up to MAX_AGE
+    uint8_t age(int x, int y) const { return ages[y][x]; }
+
+    // Bring the w x h cells in line with alive(x, y), after the board was
+    // changed other than by stepping: cells alive already keep their age,
+    // new ones start at 1 and dead ones drop to 0
+    template <typename Alive>
+    void sync(int w, int h, Alive&& alive) {
+        for (int y = 0; y < h; y++) {
+            for (int k = 0; k < (w + 31) / 32; k++) saturated[y][k] = 0;
+            for (int x = 0; x < w; x++) {
+                uint8_t& a = ages[y][x];
+                a = !alive(x, y) ? 0 : a ? a : 1;
+                if (a == MAX_AGE) saturated[y][x >> 5] |= 1u << (x & 31);
+            }
+        }
+    }
+
+    // Age the w x h cells one generation, given the alive cells of the
+    // generation they were last brought to and of the next one as bit
+    // planes (bit x & 31 of word x >> 5 in each row, as BitLife stores
+    // them). Calls emit(x, y, age) for every cell whose colour changed,
+    // with age 0 for cells that died.
+    template <typename Plane, typename Emit>
+    void update(const Plane& prev, const Plane& cur, Emit&& emit, int w = W, int h = H) {
+        int words = (w + 31) / 32;
+        for (int y = 0; y < h; y++) {
+            for (int k = 0; k < words; k++) {
+                uint32_t was = prev[y][k], now = cur[y][k];
+                uint32_t flipped = was ^ now;
+                uint32_t aging = was & now & ~saturated[y][k];
+                if (!(flipped | aging)) continue;
+
+                uint8_t* row = &ages[y][k * 32];
+                while (flipped) {
+                    int b = __builtin_ctz(flipped);
+                    flipped &= flipped - 1;
+                    uint8_t a = (now >> b) & 1;
+                    row[b] = a;
+                    emit(k * 32 + b, y, a);
+                }
+                uint32_t full = 0;
+                while (aging) {
+                    int b = __builtin_ctz(aging);
+                    aging &= aging - 1;
+                    uint8_t a = ++row[b];
+                    if (a == MAX_AGE) full |= 1u << b;
+                    if (LIFE_HEAT_PALETTE.steps_at(a)) emit(k * 32 + b, y, a);
+                }
+                saturated[y][k] = (saturated[y][k] | full) & now;
+            }
+        }
+    }
+
+private:
+    uint8_t ages[H][W] = {};
+    uint32_t saturated[H][WORDS] = {};   // Cells at MAX_AGE
+};
@@ -0,0 +1,57 @@
+/**
+ * Tufty 2040 Badge - Game of Life cycle detection
+ *
+ * Keeps the hashes of the last N generations in a ring. A generation whose
+ * hash is already in the ring repeats the board from p generations ago:
+ * the board is stuck in a period-p cycle (period 1 being a still life).
+ * Checking is N comparisons per generation however big the board is.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+template <int N>
+class LifeCycleDetector {
+public:
+    static_assert(N >= 1, "need at least one generation of history");
+
+    void reset() {
+        count = 0;
+        pos = 0;
+    }
+
+    // Record the next generation's hash with a caller-defined stamp (a
+    // frame number or time). Returns the period if it repeats one of the
+    // last N generations, else 0.
+    int push(uint64_t hash, uint32_t stamp = 0) {
+        int period = 0;
+        for (int p = 1; p <= count; p++) {
+            const Entry& e = ring[(pos - p + N) % N];
+            if (e.hash == hash) {
+                period = p;
+                matched = e.stamp;
+                break;
+            }
+        }
+        ring[pos] = {hash, stamp};
+        pos = (pos + 1) % N;
+        if (count < N) count++;
+        return period;
+    }
+
+    // Stamp of the generation the last detected cycle repeats, i.e. when
+    // the cycle began
+    uint32_t cycle_start() const { return matched; }
+
+private:
+    struct Entry {
+        uint64_t hash;
+        uint32_t stamp;
+    };
+
+    Entry ring[N] = {};
+    uint32_t matched = 0;
+    int count = 0;
+    int pos = 0;
+};
@@ -0,0 +1,82 @@
+/**
+ * Tufty 2040 Badge - lookup-table Game of Life kernel
+ *
+ * The classic 16-bit-index table: a 4x4 neighbourhood read as a 16-bit key
+ * gives the next state of its central 2x2 block. Results are 4 bits, so
+ * two are packed per byte and the table is 32 KB, generated at compile
+ * time and placed in flash.
+ *
+ * Select it with BitLife<W, H, LifeLayout::RowMajor, LutKernel<>>; each
+ * rule gets its own table.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "life.hpp"
+
+// Key layout: bits 0-3 the row above the block, 4-7 and 8-11 the block's
+// own rows, 12-15 the row below; within each row bit 0 is the leftmost of
+// the four columns. Result bits: 0-1 the block's top row, 2-3 its bottom.
+template <typename Rule = ConwayRule>
+struct LifeLut {
+    static constexpr int KEYS = 1 << 16;
+
+    uint8_t packed[KEYS / 2];
+
+    constexpr LifeLut() : packed() {
+        for (int key = 0; key < KEYS; key++) {
+            uint8_t result = 0;
+            for (int cell = 0; cell < 4; cell++) {
+                int cx = 1 + (cell & 1), cy = 1 + (cell >> 1);
+                int centre = cy * 4 + cx;
+                // The 3x3 box around the cell, minus the cell itself
+                uint32_t box = (0x7u << ((cy - 1) * 4 + cx - 1)) | (0x7u << (cy * 4 + cx - 1)) |
+                               (0x7u << ((cy + 1) * 4 + cx - 1));
+                int neighbours = __builtin_popcount(key & box & ~(1u << centre));
+                bool alive = (key >> centre) & 1;
+                if (((alive ? Rule::SURVIVE : Rule::BIRTH) >> neighbours) & 1) result |= 1 << cell;
+            }
+            packed[key >> 1] |= result << ((key & 1) * 4);
+        }
+    }
+
+    uint8_t operator[](uint32_t key) const {
+        return (packed[key >> 1] >> ((key & 1) * 4)) & 0xF;
+    }
+};
+
+// Two rows per call, 16 table lookups per word
+template <typename Rule = ConwayRule>
+struct LutKernel {
+    static constexpr int ROWS = 2;
+
+    static constexpr LifeLut<Rule> table = LifeLut<Rule>();
+
+    // Cells x - 1 .. x + 32 of word k as a 34-bit window, bit 0 = x - 1
+    template <int WORDS>
+    static inline uint64_t window(const uint32_t* r, int k) {
+        uint64_t w = (uint64_t)r[k] << 1;
+        if (k > 0) w |= r[k - 1] >> 31;
+        if (k + 1 < WORDS) w |= (uint64_t)(r[k + 1] & 1) << 33;
+        return w;
+    }
+
+    // Next state of rows r0 and r1 for word k
+    template <int WORDS>
+    static inline void next_rows(const uint32_t* up, const uint32_t* r0, const uint32_t* r1, const uint32_t* dn,
+                                 int k, uint32_t& out0, uint32_t& out1) {
+        uint64_t wu = window<WORDS>(up, k);
+        uint64_t w0 = window<WORDS>(r0, k);
+        uint64_t w1 = window<WORDS>(r1, k);
+        uint64_t wd = window<WORDS>(dn, k);
+        out0 = out1 = 0;
+        for (int b = 0; b < 32; b += 2) {
+            uint32_t key = ((wu >> b) & 0xF) | (((w0 >> b) & 0xF) << 4) |
+                           (((w1 >> b) & 0xF) << 8) | (((wd >> b) & 0xF) << 12);
+            uint32_t next = table[key];
+            out0 |= (next & 3) << b;
+            out1 |= (next >> 2) << b;
+        }
+    }
+};
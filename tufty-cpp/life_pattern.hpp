@@ -0,0 +1,315 @@
+/**
+ * Tufty 2040 Badge - Life pattern files
+ *
+ * Streaming parsers for the two common pattern formats:
+ * - RLE (.rle): "x = m, y = n, rule = B3/S23" header, then runs of
+ *   b (dead), o (alive), $ (end of row), ending with !
+ * - Plaintext (.cells): rows of . (dead) and O (alive), ! comment lines
+ *
+ * Input is fed in chunks of any size, so a pattern is read straight off
+ * the filesystem through a small buffer and never held in memory whole.
+ * Cells are reported as they are decoded.
+ *
+ * Header-only and free of Pico SDK dependencies so it also builds on the
+ * host (see bench/).
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <strings.h>
+#include <cstring>
+
+enum class LifePatternFormat {
+    Rle,
+    Plaintext
+};
+
+// .rle files are RLE, anything else (.cells, .txt) is read as plaintext
+inline LifePatternFormat life_pattern_format(const char* name) {
+    size_t len = strlen(name);
+    return len >= 4 && strcasecmp(name + len - 4, ".rle") == 0 ? LifePatternFormat::Rle : LifePatternFormat::Plaintext;
+}
+
+class LifePatternParser {
+public:
+    explicit LifePatternParser(LifePatternFormat format) { reset(format); }
+
+    void reset(LifePatternFormat f) {
+        format = f;
+        state = LineStart;
+        x = y = 0;
+        run = 0;
+        line_len = 0;
+        header_width = header_height = -1;
+        max_x = max_y = 0;
+        alive = 0;
+        rule = false;
+        birth_mask = survive_mask = 0;
+        state_count = 2;
+    }
+
+    // Parse the next chunk, calling cell(x, y) for every alive cell, in
+    // pattern coordinates from the top-left of its bounding box
+    template <typename Cell>
+    void feed(const char* data, size_t len, Cell&& cell) {
+        for (size_t i = 0; i < len && state != Done; i++) {
+            char c = data[i];
+            if (format == LifePatternFormat::Rle) {
+                rle(c, cell);
+            } else {
+                plaintext(c, cell);
+            }
+        }
+    }
+
+    // True once an RLE pattern's closing ! has been read
+    bool done() const { return state == Done; }
+
+    // Bounding box: from the RLE header if there is one, else the extent
+    // of the cells parsed so far
+    bool header_size() const { return header_width >= 0 && header_height >= 0; }
+    int width() const { return header_size() ? header_width : max_x; }
+    int height() const { return header_size() ? header_height : max_y; }
+
+    // Alive cells reported so far
+    uint32_t cells() const { return alive; }
+
+    // Rule from the RLE header as LifeRule B/S masks, if one was given.
+    // A Generations rule (B2/S/3: a third field giving more than two
+    // states) is no B/S rule: has_rule() is false and states() says why.
+    bool has_rule() const { return rule && state_count == 2; }
+    int states() const { return state_count; }
+    uint16_t birth() const { return birth_mask; }
+    uint16_t survive() const { return survive_mask; }
+
+private:
+    enum State : uint8_t {
+        LineStart,   // Start of a line before the pattern body
+        Comment,     // Skipping to the end of the line
+        Header,      // Collecting the RLE header line
+        Body,        // RLE runs, or plaintext rows
+        Done
+    };
+
+    static constexpr int LINE_MAX = 96;
+
+    template <typename Cell>
+    void rle(char c, Cell& cell) {
+        switch (state) {
+        case LineStart:
+            if (c == '#') {
+                state = Comment;
+            } else if (c == 'x' || c == 'X') {
+                state = Header;
+                line_len = 0;
+                line[line_len++] = c;
+            } else if (c != '\n' && c != '\r' && c != ' ' && c != '\t') {
+                // No header: the body starts right away
+                state = Body;
+                rle(c, cell);
+            }
+            break;
+        case Comment:
+            if (c == '\n') state = LineStart;
+            break;
+        case Header:
+            if (c == '\n') {
+                line[line_len] = '\0';
+                parse_header();
+                state = Body;
+            } else if (line_len < LINE_MAX - 1) {
+                line[line_len++] = c;
+            }
+            break;
+        case Body:
+            if (c >= '0' && c <= '9') {
+                run = run * 10 + (c - '0');
+                if (run > RUN_MAX) run = RUN_MAX;
+                break;
+            }
+            if ((c >= 'p' && c <= 'y') || c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+                // Multi-state prefixes and whitespace carry no run
+                break;
+            }
+            {
+                int n = run ? run : 1;
+                run = 0;
+                if (c == 'b' || c == '.') {
+                    x += n;
+                } else if (c == '$') {
+                    y += n;
+                    x = 0;
+                } else if (c == '!') {
+                    state = Done;
+                } else if (c == 'o' || (c >= 'A' && c <= 'X')) {
+                    // o, or any multi-state letter, is alive
+                    for (int i = 0; i < n; i++) emit(x++, y, cell);
+                }
+            }
+            break;
+        case Done:
+            break;
+        }
+    }
+
+    template <typename Cell>
+    void plaintext(char c, Cell& cell) {
+        switch (state) {
+        case LineStart:
+            if (c == '!') {
+                state = Comment;
+                break;
+            }
+            state = Body;
+            plaintext(c, cell);
+            break;
+        case Comment:
+            if (c == '\n') state = LineStart;
+            break;
+        case Body:
+            if (c == '\n') {
+                y++;
+                x = 0;
+                state = LineStart;
+            } else if (c == 'O' || c == 'o' || c == '*') {
+                emit(x++, y, cell);
+            } else if (c != '\r') {
+                x++;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    template <typename Cell>
+    void emit(int cx, int cy, Cell& cell) {
+        if (cx + 1 > max_x) max_x = cx + 1;
+        if (cy + 1 > max_y) max_y = cy + 1;
+        alive++;
+        cell(cx, cy);
+    }
+
+    // "x = 36, y = 9, rule = B3/S23"
+    void parse_header() {
+        for (char* p = line; *p; p++) {
+            while (*p == ' ' || *p == ',') p++;
+            char key = *p;
+            if (key == '\0') break;
+            char* value = strchr(p, '=');
+            if (!value) break;
+            value++;
+            while (*value == ' ') value++;
+            if (key == 'x' || key == 'X') {
+                header_width = number(value);
+            } else if (key == 'y' || key == 'Y') {
+                header_height = number(value);
+            } else if (key == 'r' || key == 'R') {
+                parse_rule(value);
+            }
+            p = strchr(value, ',');
+            if (!p) break;
+        }
+    }
+
+    static int number(const char* s) {
+        int n = 0;
+        while (*s >= '0' && *s <= '9') n = n * 10 + (*s++ - '0');
+        return n;
+    }
+
+    // Neighbour counts as a mask, up to the next '/' or ','
+    static uint16_t counts(const char*& s) {
+        uint16_t mask = 0;
+        while (*s >= '0' && *s <= '8') mask |= 1 << (*s++ - '0');
+        return mask;
+    }
+
+    // B3/S23, or the older S/B form 23/3, either with an optional third
+    // field for the Generations state count: B2/S/3, B2/S/C3 or /2/3
+    void parse_rule(const char* s) {
+        if (*s == 'B' || *s == 'b') {
+            s++;
+            birth_mask = counts(s);
+            if (*s == '/') s++;
+            if (*s == 'S' || *s == 's') s++;
+            survive_mask = counts(s);
+        } else if (*s == 'S' || *s == 's') {
+            s++;
+            survive_mask = counts(s);
+            if (*s == '/') s++;
+            if (*s == 'B' || *s == 'b') s++;
+            birth_mask = counts(s);
+        } else {
+            survive_mask = counts(s);
+            if (*s == '/') s++;
+            birth_mask = counts(s);
+        }
+        if (*s == '/') {
+            s++;
+            if (*s == 'C' || *s == 'c' || *s == 'G' || *s == 'g') s++;
+            state_count = number(s);
+        }
+        rule = true;
+    }
+
+    // Runs longer than any grid are clipped anyway
+    static constexpr int RUN_MAX = 1 << 20;
+
+    LifePatternFormat format;
+    State state;
+    int x, y;
+    int run;
+    char line[LINE_MAX];
+    int line_len;
+    int header_width, header_height;
+    int max_x, max_y;
+    uint32_t alive;
+    bool rule;
+    uint16_t birth_mask, survive_mask;
+    int state_count;
+};
+
+// Load a pattern centred on (cx, cy) of a grid exposing WIDTH, HEIGHT and
+// set(), clipped to its interior. source.read(buf, len) returns the bytes
+// read (0 at the end) and source.rewind() starts over; plaintext files,
+// having no header, are read twice to measure them first. An RLE file
+// without a header is placed with its top-left corner at (cx, cy).
+// Returns the number of cells placed; parser is left holding the header.
+template <typename Grid, typename Source>
+uint32_t load_life_pattern(Grid& grid, LifePatternParser& parser, LifePatternFormat format, Source& source, int cx,
+                           int cy) {
+    char buf[256];
+    int n;
+
+    bool measured = false;
+    if (format == LifePatternFormat::Plaintext) {
+        parser.reset(format);
+        while ((n = source.read(buf, sizeof(buf))) > 0) parser.feed(buf, n, [](int, int) {});
+        source.rewind();
+        measured = true;
+    }
+    int ox = cx - parser.width() / 2;
+    int oy = cy - parser.height() / 2;
+
+    uint32_t placed = 0;
+    bool first = true;
+    parser.reset(format);
+    auto place = [&](int x, int y) {
+        if (first && !measured) {
+            // The RLE header, if any, has been read by the first cell
+            ox = parser.header_size() ? cx - parser.width() / 2 : cx;
+            oy = parser.header_size() ? cy - parser.height() / 2 : cy;
+        }
+        first = false;
+        int gx = ox + x, gy = oy + y;
+        if (gx >= 1 && gx < Grid::WIDTH - 1 && gy >= 1 && gy < Grid::HEIGHT - 1) {
+            grid.set(gx, gy);
+            placed++;
+        }
+    };
+    while (!parser.done() && (n = source.read(buf, sizeof(buf))) > 0) parser.feed(buf, n, place);
+    return placed;
+}
@@ -0,0 +1,279 @@
+/**
+ * Tufty 2040 Badge - two-stage Game of Life pipeline
+ *
+ * The worker (core1 on the device) owns the grid and computes generation
+ * N+1 while the caller (core0) draws and transmits generation N. Each
+ * generation is handed over as a snapshot of its alive plane through a
+ * lock-free queue, and slots come back through a second queue once the
+ * caller no longer needs them to work out dying cells.
+ *
+ * The grid may be larger than the display: only a window of it, the
+ * viewport, is snapshotted and drawn. The caller moves the viewport with
+ * set_origin() while running; the worker cuts each generation at the
+ * latest origin and the caller redraws the whole view when it moves.
+ * VW x VH is the largest viewport the slots hold; set_view() picks a
+ * smaller one, e.g. when zooming in. A larger view, up to the whole grid,
+ * runs serially: next() steps the grid on the caller's core and draws
+ * from the grid's own planes, so slots need not be sized for the one
+ * view that would fill them.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <cstring>
+#include <atomic>
+#include "concurrency.hpp"
+#include "life.hpp"
+
+template <typename Grid, int VW = Grid::WIDTH, int VH = Grid::HEIGHT, int SLOTS = 4>
+class LifePipeline {
+    // The caller keeps two generations of history, the rest are in flight
+    static_assert(SLOTS >= 3, "pipeline needs at least three slots");
+    static_assert(VW <= Grid::WIDTH && VH <= Grid::HEIGHT, "viewport larger than the grid");
+
+    // Largest viewport-sized grid type, for its plane layout and diff()
+    using View = BitLife<VW, VH>;
+
+public:
+    explicit LifePipeline(Grid& grid) : grid(grid) {}
+
+    // Size the viewport, clamped to the grid. Only while stopped; the
+    // origin is clamped again on the next set_origin().
+    void set_view(int w, int h) {
+        view_w = w < 1 ? 1 : w > Grid::WIDTH ? Grid::WIDTH : w;
+        view_h = h < 1 ? 1 : h > Grid::HEIGHT ? Grid::HEIGHT : h;
+    }
+
+    int view_width() const { return view_w; }
+    int view_height() const { return view_h; }
+
+    // The view is larger than VW x VH: no worker, next() steps the grid
+    bool serial() const { return view_w > VW || view_h > VH; }
+
+    // Advance the grid with fn instead of Grid::step(), e.g. to run another
+    // rule; nullptr restores the default. Only while stopped.
+    void set_stepper(void (*fn)(Grid&)) { stepper = fn; }
+
+    // Move the viewport's top-left corner, clamped to the grid. Takes
+    // effect from the next generation the worker computes.
+    void set_origin(int x, int y) {
+        x = x < 0 ? 0 : x > Grid::WIDTH - view_w ? Grid::WIDTH - view_w : x;
+        y = y < 0 ? 0 : y > Grid::HEIGHT - view_h ? Grid::HEIGHT - view_h : y;
+        origin.store(pack(x, y), std::memory_order_release);
+    }
+
+    // Viewport origin of the generation last returned by next()
+    int origin_x() const { return shown_origin >> 16; }
+    int origin_y() const { return shown_origin & 0xFFFF; }
+
+    // Start computing ahead. The viewport must be seeded and already
+    // drawn as Grid::state() has it, dying cells included, and the grid
+    // must not be touched by the caller until stop().
+    void start() {
+        uint32_t o = origin.load(std::memory_order_relaxed);
+        shown_origin = o;
+        active = hashed = 0;
+        shown_hash = grid.hash();
+        shown_stats = grid.stats();
+        if (serial()) return;
+
+        full.reset();
+        free.reset();
+        // The view was drawn with the grid's dying cells, so the first
+        // diff starts from its previous generation as well
+        grid.template snapshot_previous_window<VW, VH>(o >> 16, o & 0xFFFF, slots[0].cells, view_w, view_h);
+        slots[0].origin = o;
+        capture(slots[1], o);
+        older = 0;
+        prev = 1;
+        for (int i = 2; i < SLOTS; i++) free.push(i);
+
+        stopping.store(false, std::memory_order_release);
+        worker.start(worker_entry, this);
+    }
+
+    // Stop computing ahead. The grid is left ahead() generations past the
+    // one last returned by next().
+    void stop() {
+        if (serial()) return;
+        stopping.store(true, std::memory_order_release);
+        worker.join();
+    }
+
+    // Wait for the next generation and call emit(x, y, state) in viewport
+    // coordinates for each cell whose drawn state changed. Returns true if
+    // the viewport moved, in which case every cell was emitted.
+    template <typename Emit>
+    bool next(Emit&& emit) {
+        if (serial()) return next_serial(emit);
+        int cur = wait();
+        const Slot& a2 = slots[older];
+        const Slot& a1 = slots[prev];
+        const Slot& a0 = slots[cur];
+        bool moved = a0.origin != a1.origin;
+        if (moved) {
+            // The old view is useless for diffing: draw alive and dead
+            for (int y = 0; y < view_h; y++) {
+                for (int x = 0; x < view_w; x++) {
+                    emit(x, y, (a0.cells[y][x >> 5] >> (x & 31)) & 1 ? LIFE_ALIVE : LIFE_DEAD);
+                }
+            }
+        } else {
+            // Right after a move nothing was drawn dying, as if a2 == a1
+            View::diff(a2.origin == a1.origin ? a2.cells : a1.cells, a1.cells, a0.cells, emit, view_h,
+                       (view_w + 31) / 32);
+        }
+        retire(cur);
+        return moved;
+    }
+
+    // next() for callers that work out what to draw themselves: waits for
+    // the next generation and calls visit(prev, cur, moved) with the
+    // viewport planes of the generation last returned and of the new one.
+    // Only the first view_width() x view_height() cells are meaningful.
+    // Not for serial() views, which have no planes of their own.
+    template <typename Visit>
+    bool next_view(Visit&& visit) {
+        int cur = wait();
+        bool moved = slots[cur].origin != slots[prev].origin;
+        visit(slots[prev].cells, slots[cur].cells, moved);
+        retire(cur);
+        return moved;
+    }
+
+    // Generations the worker computed that next() never returned, which
+    // the grid is that far ahead of the view. Only while stopped.
+    int ahead() const { return serial() ? 0 : full.size(); }
+
+    // Tiles the worker recomputed for the generation last returned by next()
+    int active_tiles() const { return active; }
+
+    // Grid::hashed_words() of the generation last returned by next()
+    int hashed_words() const { return hashed; }
+
+    // Grid::hash() of the generation last returned by next()
+    uint64_t hash() const { return shown_hash; }
+
+    // Grid::stats() of the generation last returned by next()
+    const LifeStats& stats() const { return shown_stats; }
+
+private:
+    struct Slot {
+        typename View::Plane cells;
+        uint32_t origin;
+        int active_tiles;
+        int hashed_words;
+        uint64_t hash;
+        LifeStats stats;
+    };
+
+    // Queues are powers of two and must hold every slot
+    static constexpr int queue_size(int n) {
+        int q = 1;
+        while (q < n) q <<= 1;
+        return q;
+    }
+
+    static constexpr uint32_t pack(int x, int y) { return ((uint32_t)x << 16) | (uint32_t)y; }
+
+    // Slot of the next computed generation
+    int wait() {
+        int cur;
+        while (!full.pop(cur)) {
+            Worker::relax();
+        }
+        return cur;
+    }
+
+    // Make cur the generation last returned and recycle the oldest slot
+    void retire(int cur) {
+        shown_origin = slots[cur].origin;
+        active = slots[cur].active_tiles;
+        hashed = slots[cur].hashed_words;
+        shown_hash = slots[cur].hash;
+        shown_stats = slots[cur].stats;
+        free.push(older);
+        older = prev;
+        prev = cur;
+    }
+
+    void capture(Slot& slot, uint32_t o) {
+        grid.template snapshot_window<VW, VH>(o >> 16, o & 0xFFFF, slot.cells, view_w, view_h);
+        slot.origin = o;
+    }
+
+    void advance() {
+        if (stepper) {
+            stepper(grid);
+        } else {
+            grid.step();
+        }
+    }
+
+    // next() for a serial() view: step here and emit the changes in view
+    // from the grid's last three generations, or every cell if it moved
+    template <typename Emit>
+    bool next_serial(Emit& emit) {
+        advance();
+        uint32_t o = origin.load(std::memory_order_relaxed);
+        int x0 = o >> 16, y0 = o & 0xFFFF;
+        bool moved = o != shown_origin;
+        if (moved) {
+            for (int y = 0; y < view_h; y++) {
+                for (int x = 0; x < view_w; x++) emit(x, y, grid.alive(x0 + x, y0 + y) ? LIFE_ALIVE : LIFE_DEAD);
+            }
+        } else {
+            grid.for_each_change([&](int x, int y, uint8_t s) {
+                x -= x0;
+                y -= y0;
+                if (x >= 0 && x < view_w && y >= 0 && y < view_h) emit(x, y, s);
+            });
+        }
+        shown_origin = o;
+        active = grid.active_tiles();
+        hashed = grid.hashed_words();
+        shown_hash = grid.hash();
+        shown_stats = grid.stats();
+        return moved;
+    }
+
+    static void worker_entry(void* self) {
+        static_cast<LifePipeline*>(self)->produce();
+    }
+
+    void produce() {
+        while (!stopping.load(std::memory_order_acquire)) {
+            int slot;
+            if (!free.pop(slot)) {
+                Worker::relax();
+                continue;
+            }
+            advance();
+            capture(slots[slot], origin.load(std::memory_order_acquire));
+            slots[slot].active_tiles = grid.active_tiles();
+            slots[slot].hashed_words = grid.hashed_words();
+            slots[slot].hash = grid.hash();
+            slots[slot].stats = grid.stats();
+            full.push(slot);
+        }
+    }
+
+    Grid& grid;
+    void (*stepper)(Grid&) = nullptr;
+    int view_w = VW, view_h = VH;
+    Worker worker;
+    Slot slots[SLOTS];
+    SpscQueue<int, queue_size(SLOTS)> full;   // worker -> caller: computed generations
+    SpscQueue<int, queue_size(SLOTS)> free;   // caller -> worker: slots to fill
+    std::atomic<bool> stopping{false};
+    std::atomic<uint32_t> origin{0};
+
+    // Caller side only: slots of the last two generations returned, and
+    // what next() last returned
+    int older = 0, prev = 1;
+    uint32_t shown_origin = 0;
+    int active = 0, hashed = 0;
+    uint64_t shown_hash = 0;
+    LifeStats shown_stats = {};
+};
@@ -0,0 +1,196 @@
+/**
+ * Tufty 2040 Badge - Game of Life rendering
+ *
+ * Cells are written straight into the RGB565 framebuffer instead of going
+ * through PicoGraphics::set_pen() and rectangle(), which clip and dispatch
+ * per call. Colours are precomputed in the byte order the ST7789 expects.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "life.hpp"
+
+// RGB565 with the bytes swapped, as PicoGraphics_PenRGB565 stores pens
+constexpr uint16_t rgb565_be(uint8_t r, uint8_t g, uint8_t b) {
+    uint16_t c = ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+    return (uint16_t)((c >> 8) | (c << 8));
+}
+
+// Indexed by LIFE_DEAD / LIFE_ALIVE / LIFE_DYING
+constexpr uint16_t LIFE_PALETTE[3] = {
+    rgb565_be(0, 0, 0),
+    rgb565_be(255, 255, 255),
+    rgb565_be(255, 0, 0),
+};
+
+// Colours for Generations rules with STATES states: dead black, alive
+// white, then the decay states fading from red to dark blue
+template <int STATES>
+struct GenerationsPalette {
+    uint16_t colour[STATES];
+
+    constexpr GenerationsPalette() : colour() {
+        colour[LIFE_DEAD] = rgb565_be(0, 0, 0);
+        colour[LIFE_ALIVE] = rgb565_be(255, 255, 255);
+        for (int s = 2; s < STATES; s++) {
+            int t = STATES > 3 ? (s - 2) * 255 / (STATES - 3) : 0;
+            colour[s] = rgb565_be((uint8_t)(255 - t * 223 / 255), 0, (uint8_t)(t * 96 / 255));
+        }
+    }
+};
+
+template <int STATES>
+inline constexpr GenerationsPalette<STATES> GENERATIONS_PALETTE = GenerationsPalette<STATES>();
+
+// Heat-map colours by cell age (see life_age.hpp): dead black, newborn
+// white, then through yellow and red to blue for cells alive 255
+// generations or more. Ages are bucketed in half octaves (1, 2, 3, 4, 6,
+// 8, 12, ...) so an aging cell changes colour less and less often.
+struct LifeHeatPalette {
+    static constexpr int BUCKETS = 16;
+
+    uint16_t colour[256];
+    uint32_t steps[8];   // Bit a set when colour[a] differs from colour[a - 1]
+
+    // First age of bucket b; the last bucket is the saturated age alone
+    static constexpr int bucket_start(int b) {
+        return b == 0 ? 1 : b == BUCKETS - 1 ? 255 : b & 1 ? 1 << ((b + 1) / 2) : 3 << (b / 2 - 1);
+    }
+
+    constexpr LifeHeatPalette() : colour(), steps() {
+        constexpr uint8_t STOPS[6][3] = {
+            {255, 255, 255}, {255, 255, 0}, {255, 128, 0}, {255, 0, 0}, {160, 0, 160}, {32, 64, 255},
+        };
+        int b = 0;
+        for (int age = 1; age < 256; age++) {
+            while (b + 1 < BUCKETS && age >= bucket_start(b + 1)) b++;
+            // Position along the five segments between stops, 8.8 fixed point
+            int t = b * 5 * 256 / (BUCKETS - 1);
+            int s = t >> 8 < 5 ? t >> 8 : 4, f = t - s * 256;
+            uint8_t rgb[3] = {};
+            for (int c = 0; c < 3; c++) rgb[c] = (uint8_t)(STOPS[s][c] + (STOPS[s + 1][c] - STOPS[s][c]) * f / 256);
+            colour[age] = rgb565_be(rgb[0], rgb[1], rgb[2]);
+        }
+        for (int age = 1; age < 256; age++) {
+            if (colour[age] != colour[age - 1]) steps[age >> 5] |= 1u << (age & 31);
+        }
+    }
+
+    // Whether a cell turning age draws differently from age - 1
+    constexpr bool steps_at(int age) const { return (steps[age >> 5] >> (age & 31)) & 1; }
+};
+
+inline constexpr LifeHeatPalette LIFE_HEAT_PALETTE = LifeHeatPalette();
+
+// Two pixels stored at once; may alias the uint16_t framebuffer
+typedef uint32_t __attribute__((may_alias)) PixelPair;
+
+// Fill the SIZE x SIZE cell at cell coordinates (x, y). No clipping: the
+// caller guarantees the cell lies inside the framebuffer. Each size is
+// its own routine: 1 is a single store, even sizes are filled a pixel
+// pair per store (the cell starts on an even pixel, so on a word
+// boundary when stride is even), and only odd sizes above 1 loop per
+// pixel.
+template <int SIZE>
+inline void blit_cell(uint16_t* fb, int stride, int x, int y, uint16_t colour) {
+    uint16_t* p = fb + (y * SIZE) * stride + x * SIZE;
+    if constexpr (SIZE == 1) {
+        *p = colour;
+    } else if constexpr (SIZE % 2 == 0) {
+        uint32_t pair = colour * 0x10001u;
+        for (int j = 0; j < SIZE; j++) {
+            PixelPair* q = reinterpret_cast<PixelPair*>(p);
+            for (int i = 0; i < SIZE / 2; i++) q[i] = pair;
+            p += stride;
+        }
+    } else {
+        for (int j = 0; j < SIZE; j++) {
+            for (int i = 0; i < SIZE; i++) p[i] = colour;
+            p += stride;
+        }
+    }
+}
+
+// Tracks which cells were redrawn this frame so only those parts of the
+// framebuffer are sent to the display. Dirty cells are kept as a column
+// span per cell row; consecutive dirty rows are merged into one window
+// while that costs little clean area.
+template <int W, int H, int SIZE>
+class DirtyRegion {
+public:
+    // Above this share of the grid area a single window is sent instead
+    static constexpr int FULL_PERCENT = 75;
+
+    // Clean cells a window may carry to avoid opening another one
+    static constexpr int MERGE_SLACK = 8;
+
+    DirtyRegion() { clear(); }
+
+    void clear() {
+        for (int y = 0; y < H; y++) {
+            lo[y] = W;
+            hi[y] = -1;
+        }
+    }
+
+    void mark(int x, int y) {
+        if (x < lo[y]) lo[y] = (int16_t)x;
+        if (x > hi[y]) hi[y] = (int16_t)x;
+    }
+
+    // Call window(x, y, w, h) in pixels for each region to transmit, then
+    // reset. Returns the number of windows sent.
+    template <typename Window>
+    int flush(Window&& window) {
+        int area = 0;
+        for_each_band([&](int x0, int x1, int y0, int y1) {
+            area += (x1 - x0 + 1) * (y1 - y0 + 1);
+        });
+
+        int count = 0;
+        if (area == 0) {
+            return 0;
+        } else if (area * 100 >= W * H * FULL_PERCENT) {
+            window(0, 0, W * SIZE, H * SIZE);
+            count = 1;
+        } else {
+            for_each_band([&](int x0, int x1, int y0, int y1) {
+                window(x0 * SIZE, y0 * SIZE, (x1 - x0 + 1) * SIZE, (y1 - y0 + 1) * SIZE);
+                count++;
+            });
+        }
+        clear();
+        return count;
+    }
+
+private:
+    // Runs of consecutive dirty rows as inclusive cell ranges
+    template <typename Band>
+    void for_each_band(Band&& band) const {
+        int y = 0;
+        while (y < H) {
+            if (hi[y] < 0) {
+                y++;
+                continue;
+            }
+            // Grow the band downwards while the cells it would send but
+            // that are clean stay within MERGE_SLACK
+            int y0 = y, x0 = lo[y], x1 = hi[y];
+            int used = x1 - x0 + 1;
+            while (++y < H && hi[y] >= 0) {
+                int nx0 = lo[y] < x0 ? lo[y] : x0;
+                int nx1 = hi[y] > x1 ? hi[y] : x1;
+                int nused = used + hi[y] - lo[y] + 1;
+                if ((nx1 - nx0 + 1) * (y - y0 + 1) - nused > MERGE_SLACK) break;
+                x0 = nx0;
+                x1 = nx1;
+                used = nused;
+            }
+            band(x0, x1, y0, y - 1);
+        }
+    }
+
+    int16_t lo[H];
+    int16_t hi[H];
+};
@@ -0,0 +1,63 @@
+/**
+ * Tufty 2040 Badge - reproducible Game of Life runs
+ *
+ * Random soups are drawn from a 32-bit seed with the firmware's LCG, so
+ * a run started from a printed seed can be repeated exactly.
+ * replay_life() is the headless form: seed a soup, step it a number of
+ * generations without drawing, and report a checksum over every
+ * generation's hash and the time the steps took. With the same seed,
+ * rule and grid type the checksum is the same on the badge and on the
+ * host, which makes it a fixed workload for comparing kernels.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+// The firmware's LCG (fast_rand()), 15 bits per call
+inline uint32_t life_rand(uint32_t& seed) {
+    seed = seed * 1103515245 + 12345;
+    return (seed >> 16) & 0x7FFF;
+}
+
+// Set `dots` random cells inside the grid's one-cell border
+template <typename Grid>
+void seed_life_soup(Grid& grid, uint32_t& seed, int dots) {
+    for (int i = 0; i < dots; i++) {
+        int x = 1 + (life_rand(seed) % (Grid::WIDTH - 2));
+        int y = 1 + (life_rand(seed) % (Grid::HEIGHT - 2));
+        grid.set(x, y);
+    }
+}
+
+// Fold one generation's hash into a run's checksum
+constexpr uint64_t life_checksum(uint64_t checksum, uint64_t hash) {
+    return (checksum ^ hash) * 0x100000001B3ull;
+}
+
+struct LifeReplay {
+    uint32_t seed;
+    uint32_t generations;
+    uint64_t checksum;     // Of the soup and every generation after it
+    uint32_t population;   // Alive after the last generation
+    uint64_t us;           // Stepping only, not seeding
+};
+
+// Clear the grid, seed a soup of one cell in four from seed and advance it
+// `generations` times with step. now_us() is the clock the steps are timed
+// with.
+template <typename Grid, typename Clock>
+LifeReplay replay_life(Grid& grid, uint32_t seed, uint32_t generations, void (*step)(Grid&), Clock&& now_us) {
+    grid.clear();
+    uint32_t s = seed;
+    seed_life_soup(grid, s, Grid::WIDTH * Grid::HEIGHT / 4);
+    uint64_t checksum = life_checksum(0, grid.hash());
+
+    uint64_t t0 = now_us();
+    for (uint32_t g = 0; g < generations; g++) {
+        step(grid);
+        checksum = life_checksum(checksum, grid.hash());
+    }
+    uint64_t us = now_us() - t0;
+    return {seed, generations, checksum, grid.stats().population, us};
+}
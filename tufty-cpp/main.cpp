@@ -4,19 +4,44 @@
  * Features:
  * - PNG slideshow from LittleFS flash filesystem
  * - Name badge display
- * - Game of Life with differential rendering
+ * - Game of Life with differential rendering, computed on core1 at 2
+ *   pixels per cell or larger
+ * - Game of Life paced to LIFE_TARGET_FPS, running several generations
+ *   per displayed frame when the display update leaves time for them
  *
  * Buttons:
  * - A: Skip to next image
  * - B: Show name badge for 60 seconds
  * - C: Enter/exit Game of Life mode
+ * - C (in Game of Life): Cycle pan, rule and zoom controls; hold to exit
+ * - UP/DOWN/A/B (in Game of Life, pan controls): Pan the viewport
+ * - UP/DOWN (in Game of Life, rule controls): Next/previous rule (Conway,
+ *   HighLife, ..., then the multi-state Generations rules)
+ * - B (in Game of Life, rule controls): Jump LIFE_JUMP generations ahead
+ *   (B/S rules only)
+ * - UP/DOWN (in Game of Life, zoom controls): Larger/smaller cells, 1 to 8
+ *   pixels (B/S rules only)
+ * - A (in Game of Life, zoom controls): Show/hide the statistics strip
+ * - B (in Game of Life, zoom controls): Colour cells by age (heat map), at
+ *   3 pixels per cell or larger (B/S rules only)
+ *
+ * With LIFE_STATS_CSV set, each generation's statistics are also printed
+ * to USB stdio while a B/S rule runs, as CSV lines starting "stats,"
+ * (header printed on entry).
+ *
+ * Each Life run prints the seed of its random soup. A number in
+ * life/seed.txt, or "seed <n>" typed over USB during the slideshow, fixes
+ * it for repeatable runs; "replay <generations> [seed]" steps a soup
+ * without drawing and prints a checksum and the time taken.
  */
 
 #include "pico/stdlib.h"
 #include <stdio.h>
+#include <cstdlib>
 #include <cstring>
 #include <string>
 #include <algorithm>
+#include <new>
 #include "pico/time.h"
 #include "pico/platform.h"
 #include "hardware/gpio.h"
@@ -27,6 +52,22 @@
 #include "libraries/pico_graphics/pico_graphics.hpp"
 #include "tufty2040.hpp"
 #include "PNGdec.h"
+#include "image565.hpp"
+#include "image_blob.hpp"
+#include "image_prefetch.hpp"
+#include "image_scale.hpp"
+#include "life.hpp"
+#if LIFE_USE_LUT
+#include "life_lut.hpp"
+#endif
+#include "life_render.hpp"
+#include "life_pipeline.hpp"
+#include "generations.hpp"
+#include "life_pattern.hpp"
+#include "life_cycle.hpp"
+#include "life_age.hpp"
+#include "frame_pacer.hpp"
+#include "life_replay.hpp"
 
 // LittleFS filesystem
 extern "C" {
@@ -52,11 +93,14 @@ ST7789 st7789(
     }
 );
 
-// Use RGB565 for better color quality (16-bit color)
+// Use RGB565 for better color quality (16-bit color). The framebuffer is
+// allocated on the heap.
 PicoGraphics_PenRGB565 graphics(st7789.width, st7789.height, nullptr);
 
-// PNG decoder
-PNG png;
+// Fits decoded PNG rows of any size to the screen (image_scaler). 640
+// pixels is as wide as PNGdec's default buffer decodes an RGBA image.
+constexpr int IMAGE_MAX_WIDTH = 640;
+constexpr ScaleFilter IMAGE_SCALE_FILTER = ScaleFilter::Box;
 
 // Button pins
 #define BUTTON_A    Tufty2040::A     // GPIO 7
@@ -65,16 +109,86 @@ PNG png;
 #define BUTTON_UP   Tufty2040::UP    // GPIO 22
 #define BUTTON_DOWN Tufty2040::DOWN  // GPIO 6
 
-// Game of Life constants - 106x80 grid with 3x3 pixel cells
-constexpr int LIFE_X = 106;
-constexpr int LIFE_Y = 80;
-constexpr int LIFE_SIZE = 3;
+// Game of Life constants - a universe the size of the display at 1 pixel
+// per cell (3 planes of 9.6 KB), seen through a viewport whose size
+// follows the zoom level: 106x80 cells at 3 pixels, 40x30 at 8
+constexpr int LIFE_UNIVERSE_X = Tufty2040::WIDTH;
+constexpr int LIFE_UNIVERSE_Y = Tufty2040::HEIGHT;
 constexpr int LIFE_FRAMES = 500;
-constexpr int INITIAL_DOTS = 2000;
+constexpr int INITIAL_DOTS = LIFE_UNIVERSE_X * LIFE_UNIVERSE_Y / 4;  // ~2000 per 106x80 screenful
+constexpr int LIFE_PAN = 8;             // Cells per frame while a pan button is held
+constexpr int LIFE_CYCLE_MAX = 16;      // Longest period detected as stagnation
+constexpr int LIFE_GLIDERS = 4;         // Gliders injected into a stagnant board
+constexpr uint32_t LIFE_EXIT_HOLD_MS = 1000;
+constexpr int LIFE_JUMP = 1024;
+constexpr int LIFE_HUD_HEIGHT = 10;     // Statistics strip across the top
+constexpr bool LIFE_STATS_CSV = false;  // Per-generation statistics over USB; slows stepping
+constexpr uint32_t LIFE_TARGET_FPS = 30;
+constexpr int LIFE_MAX_GENERATIONS = 8; // Per displayed frame, when computing is cheap
+
+// Generations rules run on a board the size of the 3 pixel viewport, and
+// pin the zoom there while they are selected
+constexpr int LIFE_GENERATIONS_SIZE = 3;
+constexpr int LIFE_GENERATIONS_X = Tufty2040::WIDTH / LIFE_GENERATIONS_SIZE;
+constexpr int LIFE_GENERATIONS_Y = Tufty2040::HEIGHT / LIFE_GENERATIONS_SIZE;
+
+// Cell ages for the heat map are kept for views of 3 pixel cells or
+// larger, a byte per cell (8.5 KB)
+constexpr int LIFE_HEAT_SIZE = 3;
+constexpr int LIFE_HEAT_X = Tufty2040::WIDTH / LIFE_HEAT_SIZE;
+constexpr int LIFE_HEAT_Y = Tufty2040::HEIGHT / LIFE_HEAT_SIZE;
+
+// Generation kernel, chosen at build time with -DLIFE_USE_LUT=ON
+#if LIFE_USE_LUT
+template <typename Rule> using LifeKernel = LutKernel<Rule>;
+#else
+template <typename Rule> using LifeKernel = SwarKernel<Rule>;
+#endif
+
+// Bit-packed Game of Life universe (keeps the last three generations),
+// stored row-major so cells are drawn in framebuffer scanline order
+using LifeBoard = BitLife<LIFE_UNIVERSE_X, LIFE_UNIVERSE_Y, LifeLayout::RowMajor, LifeKernel<ConwayRule>>;
+
+// Universe position of the viewport's top-left cell
+int view_x = 0;
+int view_y = 0;
+
+// Rules cycled with UP/DOWN, each compiled to its own kernel (with
+// LIFE_USE_LUT, each one a 32 KB table in flash)
+const LifeRuleEntry<LifeBoard> LIFE_RULES[] = {
+    life_rule_entry<LifeBoard, ConwayRule, LifeKernel>(),
+    life_rule_entry<LifeBoard, HighLifeRule, LifeKernel>(),
+    life_rule_entry<LifeBoard, DayNightRule, LifeKernel>(),
+    life_rule_entry<LifeBoard, SeedsRule, LifeKernel>(),
+    life_rule_entry<LifeBoard, MorleyRule, LifeKernel>(),
+};
+constexpr int LIFE_RULE_COUNT = sizeof(LIFE_RULES) / sizeof(LIFE_RULES[0]);
+
+// Multi-state board for the Generations rules, stepped on core0. It covers
+// the viewport only; the universe is paused while a Generations rule runs.
+using GenerationsBoard = GenerationsLife<LIFE_GENERATIONS_X, LIFE_GENERATIONS_Y>;
+
+// Follow LIFE_RULES in the UP/DOWN cycle
+const GenerationsRuleEntry<GenerationsBoard> GENERATIONS_RULES[] = {
+    generations_rule_entry<GenerationsBoard, BriansBrainRule>(),
+    generations_rule_entry<GenerationsBoard, StarWarsRule>(),
+    generations_rule_entry<GenerationsBoard, XtasyRule>(),
+};
+constexpr int GENERATIONS_RULE_COUNT = sizeof(GENERATIONS_RULES) / sizeof(GENERATIONS_RULES[0]);
+
+// Index into LIFE_RULES, then GENERATIONS_RULES
+int life_rule = 0;
+
+// Generations since Game of Life was entered, and whether the statistics
+// strip is shown
+uint32_t life_generation = 0;
+bool life_hud = true;
 
-// Double-buffered grids for Game of Life
-uint8_t lifegrid[2][LIFE_X * LIFE_Y];
-uint8_t change_mask[LIFE_X * LIFE_Y];
+// Fits as many generations into each frame as the target frame rate allows
+FramePacer life_pacer(LIFE_TARGET_FPS, LIFE_MAX_GENERATIONS);
+
+// Whether cells are coloured by age
+bool life_heat = false;
 
 // Colors
 Pen WHITE, BLACK, RED, GREEN, BLUE, YELLOW, CYAN, MAGENTA;
@@ -83,16 +197,149 @@ Pen WHITE, BLACK, RED, GREEN, BLUE, YELLOW, CYAN, MAGENTA;
 bool fs_mounted = false;
 int image_count = 0;
 
+// Read-only image region written by build_filesystem.py --blob, the 2 MB
+// of flash below the filesystem, read in place through XIP
+constexpr uint32_t IMAGE_BLOB_SIZE = 2 * 1024 * 1024;
+constexpr uint32_t IMAGE_BLOB_OFFSET = PICO_FLASH_SIZE_BYTES - 2 * 1024 * 1024 - IMAGE_BLOB_SIZE;
+ImageBlob image_blob;
+
+// A .565 image in the blob for show_frame() to send instead of the
+// framebuffer
+const uint8_t* flash_frame = nullptr;
+
 // Image list - stores filenames found in pics/
 #define MAX_IMAGES 200
 char image_list[MAX_IMAGES][32];  // Store up to 200 filenames, 32 chars each
 
+// Pattern list - .rle/.cells files found in life/, loaded in turn each time
+// Game of Life starts, with a random soup after the last one
+#define MAX_PATTERNS 32
+char pattern_list[MAX_PATTERNS][32];
+int pattern_count = 0;
+int pattern_next = 0;
+
 // Random seed
 uint32_t rand_seed = 12345;
 
+// Seed of the current Life run, printed when it starts. Fixed by
+// life/seed.txt or the USB "seed" command, else drawn from the clock.
+uint32_t life_seed = 0;
+bool life_seed_fixed = false;
+
+// ============================================================================
+// Memory
+// ============================================================================
+
+// Staging for the next slideshow image, decoded on core1 while the current
+// one is sent to the display and shown. 16 KB holds the flat-colour images
+// the badge ships with, which stage in 4-5 KB; photos overflow it and are
+// loaded when their turn comes, as before. A whole back frame, even at
+// RGB332, does not fit next to the framebuffer and PNGdec (see
+// bench/transfer_bench).
+constexpr int PREFETCH_STAGING = 16 * 1024;
+using SlideStage = ImageStage<Tufty2040::WIDTH, PREFETCH_STAGING / 2>;
+using SlidePrefetcher = ImagePrefetcher<Tufty2040::WIDTH, Tufty2040::HEIGHT, SlideStage>;
+
+bool prefetch_decode(int index, SlideStage& stage, void*);
+
+// Game of Life and the slideshow never run at once, so their large state
+// shares one block of RAM: the boards in Life mode, the PNG decoder and
+// prefetch staging in image mode. enter_life_mode() and enter_image_mode()
+// construct one over the other.
+struct LifeState {
+    LifeBoard life;
+
+    // Computes generations on core1 while core0 draws and updates the
+    // display. Slots hold views of up to 160x120 cells (2.4 KB each), zoom
+    // 2 and up; the 1 pixel view of the whole universe is stepped on core0.
+    LifePipeline<LifeBoard, LIFE_UNIVERSE_X / 2, LIFE_UNIVERSE_Y / 2, 3> pipeline{life};
+
+    GenerationsBoard generations;
+
+    // Spots boards stuck in a still life or short oscillation
+    LifeCycleDetector<LIFE_CYCLE_MAX> cycles;
+
+    // Ages of the cells in view, for the heat map
+    LifeAge<LIFE_HEAT_X, LIFE_HEAT_Y> life_ages;
+};
+
+struct ImageState {
+    PNG png;
+    ImageScaler<Tufty2040::WIDTH, Tufty2040::HEIGHT, IMAGE_MAX_WIDTH> image_scaler;
+
+    // Core0 must cancel() it before using png or core1 for anything else
+    SlidePrefetcher prefetcher{prefetch_decode, nullptr};
+};
+
+union ModeArena {
+    LifeState life;
+    ImageState image;
+
+    ModeArena() {}
+    ~ModeArena() {}
+};
+
+enum class Mode : uint8_t {
+    None,
+    Life,
+    Images
+};
+
+ModeArena mode_arena;
+Mode mode = Mode::None;
+
+// The arena's contents by their own names, valid in their mode only
+LifeBoard& life = mode_arena.life.life;
+auto& pipeline = mode_arena.life.pipeline;
+GenerationsBoard& generations = mode_arena.life.generations;
+auto& cycles = mode_arena.life.cycles;
+auto& life_ages = mode_arena.life.life_ages;
+PNG& png = mode_arena.image.png;
+auto& image_scaler = mode_arena.image.image_scaler;
+auto& prefetcher = mode_arena.image.prefetcher;
+
+// The RP2040 has 256 KB of main SRAM for static data and the heap; the
+// stacks are in the scratch banks. The framebuffer, the arena and the
+// file lists must leave RAM_RESERVE of it for the SDK, USB stdio,
+// LittleFS, the smaller globals and the heap's overhead.
+constexpr size_t RAM_SIZE = 256 * 1024;
+constexpr size_t RAM_RESERVE = 24 * 1024;
+constexpr size_t FRAMEBUFFER_BYTES = Tufty2040::WIDTH * Tufty2040::HEIGHT * sizeof(uint16_t);
+static_assert(FRAMEBUFFER_BYTES + sizeof(ModeArena) + sizeof(image_list) + sizeof(pattern_list) <=
+              RAM_SIZE - RAM_RESERVE, "framebuffer and globals do not fit RP2040 RAM");
+
+// Switch the arena to Life's boards, stopping any prefetch first
+void enter_life_mode() {
+    if (mode == Mode::Life) return;
+    if (mode == Mode::Images) {
+        prefetcher.cancel();
+        mode_arena.image.~ImageState();
+    }
+    new (&mode_arena.life) LifeState();
+    mode = Mode::Life;
+}
+
+// Switch the arena to the PNG decoder and prefetch staging. The pipeline
+// must be stopped; the Life board is lost.
+void enter_image_mode() {
+    if (mode == Mode::Images) return;
+    if (mode == Mode::Life) mode_arena.life.~LifeState();
+    new (&mode_arena.image) ImageState();
+    mode = Mode::Images;
+}
+
+// Linker symbols: static data ends at __bss_end__, the heap runs from
+// __end__ to __StackLimit
+extern "C" char __bss_end__, __end__, __StackLimit;
+
+void print_ram_usage() {
+    printf("RAM: %lu bytes static (mode arena %u: Life %u, images %u), %lu bytes of heap for the %u byte "
+           "framebuffer\n", (uint32_t)(&__bss_end__ - (char*)SRAM_BASE), sizeof(ModeArena), sizeof(LifeState),
+           sizeof(ImageState), (uint32_t)(&__StackLimit - &__end__), FRAMEBUFFER_BYTES);
+}
+
 uint32_t fast_rand() {
-    rand_seed = rand_seed * 1103515245 + 12345;
-    return (rand_seed >> 16) & 0x7FFF;
+    return life_rand(rand_seed);
 }
 
 // Initialize button GPIOs
@@ -165,21 +412,31 @@ int32_t png_seek_callback(PNGFILE* pFile, int32_t iPosition) {
     return pico_lseek(handle->file, iPosition, LFS_SEEK_SET) >= 0 ? 1 : 0;
 }
 
-// PNG draw callback - renders directly to the framebuffer
+// PNG draw callback - renders directly to the framebuffer, centred or
+// scaled down to fit by image_scaler
 void png_draw_callback(PNGDRAW* pDraw) {
-    uint16_t lineBuffer[320];
+    uint16_t* lineBuffer = image_scaler.line();
 
     // Convert the PNG line to RGB565 - use BIG_ENDIAN for ST7789
     png.getLineAsRGB565(pDraw, lineBuffer, PNG_RGB565_BIG_ENDIAN, 0xffffffff);
 
-    // Get pointer to graphics framebuffer
-    uint16_t* fb = (uint16_t*)graphics.frame_buffer;
+    image_scaler.row(pDraw->y, lineBuffer, (uint16_t*)graphics.frame_buffer);
+}
 
-    // Copy line to framebuffer
-    int y = pDraw->y;
-    if (y < 240) {
-        memcpy(&fb[y * 320], lineBuffer, 320 * 2);
+// Set image_scaler up for the PNG just opened, with black around it if it
+// does not fill the screen
+bool begin_png_image(const char* name) {
+    int w = png.getWidth(), h = png.getHeight();
+    if (!image_scaler.begin(w, h, IMAGE_SCALE_FILTER)) {
+        printf("PNG: %s is %dx%d, wider than %d\n", name, w, h, IMAGE_MAX_WIDTH);
+        return false;
     }
+    if (image_scaler.width() != Tufty2040::WIDTH || image_scaler.height() != Tufty2040::HEIGHT) {
+        image_scaler.clear_border((uint16_t*)graphics.frame_buffer, 0);
+        printf("PNG: %s shown at %dx%d+%d+%d%s\n", name, image_scaler.width(), image_scaler.height(),
+               image_scaler.x(), image_scaler.y(), image_scaler.scaled() ? ", scaled down" : "");
+    }
+    return true;
 }
 
 // ============================================================================
@@ -201,6 +458,10 @@ bool load_png(const char* filename) {
     }
 
     printf("PNG: %dx%d, bpp=%d\n", png.getWidth(), png.getHeight(), png.getBpp());
+    if (!begin_png_image(filename)) {
+        png.close();
+        return false;
+    }
 
     // Decode the image
     result = png.decode(nullptr, 0);
@@ -214,7 +475,143 @@ bool load_png(const char* filename) {
     return true;
 }
 
-// Scan pics/ directory for PNG files (excluding tufty-name.png)
+// Read a pre-decoded .565 image straight into the framebuffer. The pixels
+// go in one read: LittleFS copies whole blocks to the destination without
+// passing them through its cache.
+bool load_raw565(const char* filename) {
+    if (!fs_mounted) {
+        printf("Filesystem not mounted\n");
+        return false;
+    }
+
+    int file = pico_open(filename, LFS_O_RDONLY);
+    if (file < 0) return false;
+
+    uint32_t t0 = time_us_32();
+    uint8_t header[IMAGE565_HEADER];
+    Image565Info info;
+    bool ok = pico_read(file, header, sizeof(header)) == IMAGE565_HEADER && image565_header(header, info);
+    if (ok && (info.width != Tufty2040::WIDTH || info.height != Tufty2040::HEIGHT)) {
+        printf("RAW: %s is %dx%d, not full screen\n", filename, info.width, info.height);
+        ok = false;
+    }
+    if (ok) ok = pico_read(file, graphics.frame_buffer, info.bytes()) == (int)info.bytes();
+    pico_close(file);
+
+    if (!ok) {
+        printf("RAW: Failed to read %s\n", filename);
+        return false;
+    }
+    printf("RAW: %s in %luus\n", filename, time_us_32() - t0);
+    return true;
+}
+
+// Decode a PNG that is already in memory, mapped from flash
+bool load_png_ram(const char* name, const uint8_t* data, uint32_t size) {
+    int result = png.openRAM((uint8_t*)data, size, png_draw_callback);
+    if (result != PNG_SUCCESS) {
+        printf("PNG: Failed to open %s, error=%d\n", name, result);
+        return false;
+    }
+
+    printf("PNG: %s from flash, %dx%d, bpp=%d\n", name, png.getWidth(), png.getHeight(), png.getBpp());
+    if (!begin_png_image(name)) {
+        png.close();
+        return false;
+    }
+    result = png.decode(nullptr, 0);
+    png.close();
+
+    if (result != PNG_SUCCESS) {
+        printf("PNG: Decode failed, error=%d\n", result);
+        return false;
+    }
+    return true;
+}
+
+// Show an image from the blob without copying it out of flash: PNGs are
+// decoded in place, .565 images are left for show_frame() to send
+// straight from flash. False if it is not in the blob.
+bool load_blob_image(const char* name) {
+    int i = image_blob.find(name);
+    if (i < 0) return false;
+    if (!image565_name(name)) return load_png_ram(name, image_blob.data(i), image_blob.size(i));
+
+    Image565Info info;
+    const uint8_t* pixels = image565_pixels(image_blob.data(i), image_blob.size(i), info);
+    if (!pixels || info.width != Tufty2040::WIDTH || info.height != Tufty2040::HEIGHT) {
+        printf("BLOB: %s is not a full-screen .565\n", name);
+        return false;
+    }
+    flash_frame = pixels;
+    printf("BLOB: %s, shown from flash\n", name);
+    return true;
+}
+
+// Show an image from the blob or pics/, pre-decoded or PNG by its
+// extension
+bool load_image(const char* name) {
+    if (load_blob_image(name)) return true;
+    char filename[64];
+    snprintf(filename, sizeof(filename), "pics/%s", name);
+    return image565_name(name) ? load_raw565(filename) : load_png(filename);
+}
+
+// Send the frame to the display: the blob image load_blob_image() left in
+// flash if there is one, else the framebuffer
+void show_frame() {
+    if (!flash_frame) {
+        st7789.update(&graphics);
+        return;
+    }
+    void* fb = graphics.frame_buffer;
+    graphics.set_framebuffer((void*)flash_frame);
+    st7789.update(&graphics);
+    graphics.set_framebuffer(fb);
+    flash_frame = nullptr;
+}
+
+// ============================================================================
+// Prefetch
+// ============================================================================
+
+// PNG draw callback for a prefetch: rows go to the staging buffer passed
+// to decode(), not to the framebuffer on show. The line buffer is static:
+// this runs on core1, whose default stack is 2 KB.
+void png_stage_callback(PNGDRAW* pDraw) {
+    static uint16_t lineBuffer[Tufty2040::WIDTH];
+    png.getLineAsRGB565(pDraw, lineBuffer, PNG_RGB565_BIG_ENDIAN, 0xffffffff);
+    ((SlideStage*)pDraw->pUser)->row(pDraw->y, lineBuffer, pDraw->iWidth);
+}
+
+// Runs on core1: decode slideshow image index into the staging buffer,
+// from the blob or pics/. A .565 is left alone: it is already one read, or
+// shown straight from flash. So is a PNG that is not full-screen, fitted to
+// the screen by load_png() when its turn comes.
+bool prefetch_decode(int index, SlideStage& stage, void*) {
+    const char* name = image_list[index];
+    if (image565_name(name)) return false;
+
+    int result;
+    int i = image_blob.find(name);
+    if (i >= 0) {
+        result = png.openRAM((uint8_t*)image_blob.data(i), image_blob.size(i), png_stage_callback);
+    } else {
+        if (!fs_mounted) return false;
+        char filename[64];
+        snprintf(filename, sizeof(filename), "pics/%s", name);
+        result = png.open(filename, png_open_callback, png_close_callback,
+                          png_read_callback, png_seek_callback, png_stage_callback);
+    }
+    if (result != PNG_SUCCESS) return false;
+
+    bool ok = png.getWidth() == Tufty2040::WIDTH && png.getHeight() == Tufty2040::HEIGHT &&
+              png.decode(&stage, 0) == PNG_SUCCESS;
+    png.close();
+    return ok;
+}
+
+// Scan pics/ directory for PNG and .565 files (excluding the name badge)
 int scan_images() {
     int count = 0;
     struct lfs_info info;
@@ -232,13 +629,13 @@ int scan_images() {
         // Skip directories
         if (info.type == LFS_TYPE_DIR) continue;
 
-        // Check if it's a PNG file (ends with .png)
+        // Check if it's a PNG or pre-decoded file (ends with .png or .565)
         int len = strlen(info.name);
         if (len < 5) continue;
-        if (strcasecmp(&info.name[len-4], ".png") != 0) continue;
+        if (strcasecmp(&info.name[len-4], ".png") != 0 && !image565_name(info.name)) continue;
 
-        // Skip tufty-name.png (name badge)
-        if (strcasecmp(info.name, "tufty-name.png") == 0) continue;
+        // Skip tufty-name.png / tufty-name.565 (name badge)
+        if (strncasecmp(info.name, "tufty-name.", 11) == 0) continue;
 
         // Add to image list
         strncpy(image_list[count], info.name, 31);
@@ -251,137 +648,630 @@ int scan_images() {
     return count;
 }
 
+// Add the image blob's entries to the image list after the count found in
+// pics/, skipping the name badge and names already listed
+int scan_blob_images(int count) {
+    for (int i = 0; i < image_blob.count() && count < MAX_IMAGES; i++) {
+        const char* name = image_blob.name(i);
+        if (strncasecmp(name, "tufty-name.", 11) == 0) continue;
+        bool listed = false;
+        for (int j = 0; j < count && !listed; j++) listed = strcmp(image_list[j], name) == 0;
+        if (listed) continue;
+
+        strncpy(image_list[count], name, 31);
+        image_list[count][31] = '\0';
+        printf("  Found: %s (%lu bytes, blob)\n", name, image_blob.size(i));
+        count++;
+    }
+    return count;
+}
+
+// Scan life/ directory for pattern files
+int scan_patterns() {
+    int count = 0;
+    struct lfs_info info;
+
+    int dir = pico_dir_open("life");
+    if (dir < 0) {
+        printf("No life/ directory\n");
+        return 0;
+    }
+
+    while (pico_dir_read(dir, &info) > 0 && count < MAX_PATTERNS) {
+        if (info.name[0] == '.') continue;
+        if (info.type == LFS_TYPE_DIR) continue;
+
+        int len = strlen(info.name);
+        bool rle = len > 4 && strcasecmp(&info.name[len-4], ".rle") == 0;
+        bool cells = len > 6 && strcasecmp(&info.name[len-6], ".cells") == 0;
+        if (!rle && !cells) continue;
+
+        strncpy(pattern_list[count], info.name, 31);
+        pattern_list[count][31] = '\0';
+        printf("  Found: %s (%ld bytes)\n", info.name, info.size);
+        count++;
+    }
+
+    pico_dir_close(dir);
+    return count;
+}
+
+// Fix the Life seed from life/seed.txt (a decimal number), if present
+void load_life_seed() {
+    int file = pico_open("life/seed.txt", LFS_O_RDONLY);
+    if (file < 0) return;
+    char text[16] = {};
+    int n = pico_read(file, text, sizeof(text) - 1);
+    pico_close(file);
+    char* end;
+    unsigned long seed = strtoul(text, &end, 10);
+    if (n <= 0 || end == text) {
+        printf("Life: ignoring life/seed.txt\n");
+        return;
+    }
+    life_seed = seed;
+    life_seed_fixed = true;
+    printf("Life: seed %lu from life/seed.txt\n", life_seed);
+}
+
 // ============================================================================
 // Game of Life
 // ============================================================================
 
-void calculate_generation(int fnow, int fnext) {
-    uint8_t* grid_now = lifegrid[fnow];
-    uint8_t* grid_next = lifegrid[fnext];
-
-    for (int x = 1; x < LIFE_X - 1; x++) {
-        int idx = x * LIFE_Y;
-        for (int y = 1; y < LIFE_Y - 1; y++) {
-            int idx_curr = idx + y;
-            int idx_up = idx_curr - LIFE_Y;
-            int idx_down = idx_curr + LIFE_Y;
-
-            int neighbors = 0;
-            if (grid_now[idx_up - 1] == 1) neighbors++;
-            if (grid_now[idx_up] == 1) neighbors++;
-            if (grid_now[idx_up + 1] == 1) neighbors++;
-            if (grid_now[idx_curr - 1] == 1) neighbors++;
-            if (grid_now[idx_curr + 1] == 1) neighbors++;
-            if (grid_now[idx_down - 1] == 1) neighbors++;
-            if (grid_now[idx_down] == 1) neighbors++;
-            if (grid_now[idx_down + 1] == 1) neighbors++;
-
-            if (grid_now[idx_curr] == 1) {
-                grid_next[idx_curr] = (neighbors >= 2 && neighbors <= 3) ? 1 : 2;
-            } else {
-                grid_next[idx_curr] = (neighbors == 3) ? 1 : 0;
-            }
+// Cells redrawn since the last display update, per zoom level
+template <int SIZE>
+DirtyRegion<Tufty2040::WIDTH / SIZE, Tufty2040::HEIGHT / SIZE, SIZE> zoom_dirty;
+
+// Redraw one cell whose state changed this generation
+template <int SIZE>
+void draw_cell(int x, int y, uint8_t state) {
+    blit_cell<SIZE>((uint16_t*)graphics.frame_buffer, Tufty2040::WIDTH, x, y, LIFE_PALETTE[state]);
+    zoom_dirty<SIZE>.mark(x, y);
+}
+
+// Redraw one cell whose heat-map colour changed; age 0 is dead
+template <int SIZE>
+void draw_heat_cell(int x, int y, uint8_t age) {
+    blit_cell<SIZE>((uint16_t*)graphics.frame_buffer, Tufty2040::WIDTH, x, y, LIFE_HEAT_PALETTE.colour[age]);
+    zoom_dirty<SIZE>.mark(x, y);
+}
+
+// Send only the redrawn parts of the framebuffer to the display
+template <int SIZE>
+int update_dirty_windows() {
+    return zoom_dirty<SIZE>.flush([](int x, int y, int w, int h) {
+        st7789.partial_update(&graphics, Rect(x, y, w, h));
+    });
+}
+
+template <int SIZE>
+void clear_dirty_windows() {
+    zoom_dirty<SIZE>.clear();
+}
+
+// A zoom level, with the drawing and display update routines compiled
+// for its cell size
+struct LifeZoom {
+    int size;
+    int width, height;   // Viewport in cells
+    void (*draw)(int x, int y, uint8_t state);
+    void (*draw_heat)(int x, int y, uint8_t age);
+    int (*update)();
+    void (*clear)();
+};
+
+template <int SIZE>
+constexpr LifeZoom life_zoom_entry() {
+    return {SIZE, Tufty2040::WIDTH / SIZE, Tufty2040::HEIGHT / SIZE, draw_cell<SIZE>, draw_heat_cell<SIZE>,
+            update_dirty_windows<SIZE>, clear_dirty_windows<SIZE>};
+}
+
+// Cycled with UP/DOWN, smallest cells first
+constexpr LifeZoom LIFE_ZOOMS[] = {
+    life_zoom_entry<1>(),
+    life_zoom_entry<2>(),
+    life_zoom_entry<3>(),
+    life_zoom_entry<4>(),
+    life_zoom_entry<8>(),
+};
+constexpr int LIFE_ZOOM_COUNT = sizeof(LIFE_ZOOMS) / sizeof(LIFE_ZOOMS[0]);
+constexpr int LIFE_GENERATIONS_ZOOM = 2;
+static_assert(LIFE_ZOOMS[LIFE_GENERATIONS_ZOOM].size == LIFE_GENERATIONS_SIZE, "Generations zoom level");
+constexpr int LIFE_HEAT_ZOOM = 2;       // Smallest level with a heat map
+static_assert(LIFE_ZOOMS[LIFE_HEAT_ZOOM].size == LIFE_HEAT_SIZE, "heat map zoom level");
+
+// Index into LIFE_ZOOMS, and the level itself
+int life_zoom = LIFE_GENERATIONS_ZOOM;
+const LifeZoom* zoom = &LIFE_ZOOMS[life_zoom];
+
+// draw_cell() for the Generations board, coloured by the active rule
+const uint16_t* generations_palette = GENERATIONS_RULES[0].palette;
+
+void draw_generations_cell(int x, int y, uint8_t state) {
+    blit_cell<LIFE_GENERATIONS_SIZE>((uint16_t*)graphics.frame_buffer, Tufty2040::WIDTH, x, y,
+                                     generations_palette[state]);
+    zoom_dirty<LIFE_GENERATIONS_SIZE>.mark(x, y);
+}
+
+bool generations_active() {
+    return life_rule >= LIFE_RULE_COUNT;
+}
+
+// Pattern file streamed through load_life_pattern()
+struct LifeFileSource {
+    int file;
+
+    int read(char* buf, int len) {
+        int32_t n = pico_read(file, buf, len);
+        return n > 0 ? n : 0;
+    }
+
+    void rewind() {
+        pico_lseek(file, 0, LFS_SEEK_SET);
+    }
+};
+
+// Load life/<name> centred in the universe and centre the view on it. If
+// the file names a rule that is in LIFE_RULES, switch to it.
+bool load_life_pattern_file(const char* name) {
+    char filename[48];
+    snprintf(filename, sizeof(filename), "life/%s", name);
+    int file = pico_open(filename, LFS_O_RDONLY);
+    if (file < 0) {
+        printf("Life: failed to open %s\n", filename);
+        return false;
+    }
+
+    uint32_t t0 = millis();
+    LifeFileSource source{file};
+    LifePatternFormat format = life_pattern_format(name);
+    LifePatternParser parser(format);
+    uint32_t placed = load_life_pattern(life, parser, format, source, LIFE_UNIVERSE_X / 2, LIFE_UNIVERSE_Y / 2);
+    pico_close(file);
+    printf("Life: loaded %s, %dx%d, %lu/%lu cells in %lums\n", name, parser.width(), parser.height(), placed,
+           parser.cells(), millis() - t0);
+    if (placed == 0) return false;
+
+    if (parser.has_rule()) {
+        for (int i = 0; i < LIFE_RULE_COUNT; i++) {
+            if (LIFE_RULES[i].birth == parser.birth() && LIFE_RULES[i].survive == parser.survive()) life_rule = i;
         }
+    } else if (parser.states() > 2) {
+        printf("Life: %s has a %d-state Generations rule, run under %s\n", name, parser.states(),
+               LIFE_RULES[life_rule].name);
     }
+    view_x = (LIFE_UNIVERSE_X - zoom->width) / 2;
+    view_y = (LIFE_UNIVERSE_Y - zoom->height) / 2;
+    return true;
 }
 
-void mark_changes(int fnow, int fnext) {
-    uint8_t* grid_now = lifegrid[fnow];
-    uint8_t* grid_next = lifegrid[fnext];
+void seed_life_soup() {
+    seed_life_soup(life, rand_seed, INITIAL_DOTS);
+}
 
-    for (int i = 0; i < LIFE_X * LIFE_Y; i++) {
-        change_mask[i] = (grid_now[i] != grid_next[i]) ? grid_next[i] : 255;
+void init_life_grid() {
+    life.clear();
+    if (!life_seed_fixed) life_seed = time_us_32();
+    rand_seed = life_seed;
+    printf("Life: seed %lu\n", life_seed);
+
+    if (pattern_next < pattern_count) {
+        if (load_life_pattern_file(pattern_list[pattern_next++])) return;
+        life.clear();
+    } else {
+        pattern_next = 0;
     }
+
+    seed_life_soup();
 }
 
-void draw_changes() {
-    for (int x = 0; x < LIFE_X; x++) {
-        for (int y = 0; y < LIFE_Y; y++) {
-            uint8_t val = change_mask[x * LIFE_Y + y];
-            if (val != 255) {
-                if (val == 1) graphics.set_pen(WHITE);
-                else if (val == 2) graphics.set_pen(RED);
-                else graphics.set_pen(BLACK);
-                graphics.rectangle(Rect(x * LIFE_SIZE, y * LIFE_SIZE, LIFE_SIZE, LIFE_SIZE));
-            }
+// Shake up a board that has stopped evolving: gliders heading in random
+// directions from inside the viewport, or a fresh soup if it died out.
+// The pipeline must be stopped.
+void revive_life() {
+    if (life.hash() == 0) {
+        seed_life_soup();
+        return;
+    }
+    static const uint8_t GLIDER[5][2] = {{1, 0}, {2, 1}, {0, 2}, {1, 2}, {2, 2}};
+    for (int i = 0; i < LIFE_GLIDERS; i++) {
+        int x = view_x + 1 + fast_rand() % (zoom->width - 4);
+        int y = view_y + 1 + fast_rand() % (zoom->height - 4);
+        bool flip_x = fast_rand() & 1, flip_y = fast_rand() & 1;
+        for (const auto& c : GLIDER) {
+            life.set(x + (flip_x ? 2 - c[0] : c[0]), y + (flip_y ? 2 - c[1] : c[1]));
         }
     }
 }
 
-void init_life_grid() {
-    memset(lifegrid[0], 0, LIFE_X * LIFE_Y);
-    memset(lifegrid[1], 0, LIFE_X * LIFE_Y);
-    rand_seed = millis();
+// Jump the board ahead by stepping it without drawing. A HashLife jump
+// would need 70 KB to 2 MB of nodes for a settled 320x240 soup, more than
+// the RP2040 has. The pipeline must be stopped.
+void fast_forward_life(uint32_t generations) {
+    const LifeRuleEntry<LifeBoard>& rule = LIFE_RULES[life_rule];
+    uint32_t t0 = millis();
+    for (uint32_t i = 0; i < generations; i++) rule.step(life);
+    life_generation += generations;
+    life_ages.clear();
+    printf("Life: jumped %lu generations in %lums\n", generations, millis() - t0);
+}
+
+// Step a soup from seed without drawing and print the checksum and time,
+// to compare kernels on a fixed workload (bench/replay_bench runs the
+// same on the host). Uses the current B/S rule, Conway under a
+// Generations rule. Life mode only, with the pipeline stopped; the board
+// is lost.
+void replay_life_run(uint32_t seed, uint32_t generations) {
+    const LifeRuleEntry<LifeBoard>& rule = LIFE_RULES[generations_active() ? 0 : life_rule];
+    LifeReplay r = replay_life(life, seed, generations, rule.step, time_us_64);
+    printf("replay: seed=%lu rule=%s generations=%lu checksum=%016llx population=%lu time=%lluus "
+           "(%.1f gens/s)\n", r.seed, rule.name, r.generations, r.checksum, r.population, r.us,
+           r.us ? r.generations * 1e6 / r.us : 0.0);
+}
+
+// Lines typed over USB stdio, between slideshow images:
+//   seed <n>           fix the seed of the following Life runs
+//   seed               back to a fresh seed per run
+//   replay <n> [seed]  replay_life_run() n generations, from the current
+//                      seed if none is given
+// The arguments of line if it is the command name, else nullptr
+const char* usb_command_args(const char* line, const char* name) {
+    size_t len = strlen(name);
+    if (strncmp(line, name, len) != 0 || (line[len] != ' ' && line[len] != '\0')) return nullptr;
+    return line + len;
+}
+
+void run_usb_command(const char* line) {
+    char* end;
+    const char* args;
+    if ((args = usb_command_args(line, "seed"))) {
+        unsigned long seed = strtoul(args, &end, 10);
+        life_seed_fixed = end != args;
+        if (life_seed_fixed) life_seed = seed;
+        printf(life_seed_fixed ? "Life: seed fixed at %lu\n" : "Life: fresh seed per run\n", life_seed);
+    } else if ((args = usb_command_args(line, "replay"))) {
+        unsigned long generations = strtoul(args, &end, 10);
+        const char* rest = end;
+        unsigned long seed = strtoul(rest, &end, 10);
+        enter_life_mode();
+        replay_life_run(end != rest ? seed : life_seed, generations ? generations : LIFE_FRAMES);
+        enter_image_mode();
+    } else if (line[0]) {
+        printf("Unknown command: %s (seed [n], replay <generations> [seed])\n", line);
+    }
+}
 
-    for (int i = 0; i < INITIAL_DOTS; i++) {
-        int x = 1 + (fast_rand() % (LIFE_X - 2));
-        int y = 1 + (fast_rand() % (LIFE_Y - 2));
-        lifegrid[0][x * LIFE_Y + y] = 1;
+// Collect a line from USB stdio without blocking and run it when complete
+void poll_usb_command() {
+    static char line[40];
+    static int len = 0;
+    int c;
+    while ((c = getchar_timeout_us(0)) != PICO_ERROR_TIMEOUT) {
+        if (c != '\r' && c != '\n') {
+            if (len < (int)sizeof(line) - 1) line[len++] = (char)c;
+            continue;
+        }
+        line[len] = '\0';
+        len = 0;
+        run_usb_command(line);
     }
 }
 
-void draw_full_life_grid(int fnow) {
+void draw_full_life_grid() {
     graphics.set_pen(BLACK);
     graphics.clear();
 
-    uint8_t* grid = lifegrid[fnow];
-    for (int x = 0; x < LIFE_X; x++) {
-        for (int y = 0; y < LIFE_Y; y++) {
-            int idx = x * LIFE_Y + y;
-            if (grid[idx] == 1) {
-                graphics.set_pen(WHITE);
-                graphics.rectangle(Rect(x * LIFE_SIZE, y * LIFE_SIZE, LIFE_SIZE, LIFE_SIZE));
-            } else if (grid[idx] == 2) {
-                graphics.set_pen(RED);
-                graphics.rectangle(Rect(x * LIFE_SIZE, y * LIFE_SIZE, LIFE_SIZE, LIFE_SIZE));
+    bool heat = life_heat && !generations_active();
+    if (heat) {
+        life_ages.sync(zoom->width, zoom->height, [](int x, int y) { return life.alive(view_x + x, view_y + y); });
+    }
+    for (int y = 0; y < zoom->height; y++) {
+        for (int x = 0; x < zoom->width; x++) {
+            if (generations_active()) {
+                uint8_t state = generations.state(x, y);
+                if (state != LIFE_DEAD) draw_generations_cell(x, y, state);
+            } else if (heat) {
+                uint8_t age = life_ages.age(x, y);
+                if (age) zoom->draw_heat(x, y, age);
+            } else {
+                uint8_t state = life.state(view_x + x, view_y + y);
+                if (state != LIFE_DEAD) zoom->draw(x, y, state);
             }
         }
     }
 }
 
+// Stop computing ahead, counting the generations the worker computed but
+// never returned: the board redrawn after this is that far on
+void stop_life_pipeline() {
+    pipeline.stop();
+    life_generation += pipeline.ahead();
+}
+
+// Heat-map counterpart of pipeline.next(zoom->draw): age the cells in
+// view and redraw those whose colour changed
+void next_life_heat() {
+    pipeline.next_view([](const auto& prev, const auto& cur, bool moved) {
+        if (!moved) {
+            life_ages.update(prev, cur, zoom->draw_heat, zoom->width, zoom->height);
+            return;
+        }
+        // Cells that scrolled into view are of unknown age: start over
+        life_ages.clear();
+        life_ages.sync(zoom->width, zoom->height, [&](int x, int y) { return (cur[y][x >> 5] >> (x & 31)) & 1; });
+        for (int y = 0; y < zoom->height; y++) {
+            for (int x = 0; x < zoom->width; x++) zoom->draw_heat(x, y, life_ages.age(x, y));
+        }
+    });
+}
+
+// Draw the statistics strip over the top rows of cells, into the
+// framebuffer only; send it with update_life_hud() after the cells
+void draw_life_hud(const LifeStats& stats) {
+    char text[80];
+    int n = snprintf(text, sizeof(text), "gen %lu  pop %lu  +%lu -%lu", life_generation, stats.population,
+                     stats.births, stats.deaths);
+    if (stats.x0 <= stats.x1) {
+        snprintf(text + n, sizeof(text) - n, "  box %d,%d-%d,%d", stats.x0, stats.y0, stats.x1, stats.y1);
+    }
+    graphics.set_pen(BLACK);
+    graphics.rectangle(Rect(0, 0, Tufty2040::WIDTH, LIFE_HUD_HEIGHT));
+    graphics.set_pen(WHITE);
+    graphics.text(text, Point(2, 1), Tufty2040::WIDTH);
+}
+
+void update_life_hud() {
+    st7789.partial_update(&graphics, Rect(0, 0, Tufty2040::WIDTH, LIFE_HUD_HEIGHT));
+}
+
+void print_life_stats_csv(const LifeStats& stats) {
+    printf("stats,%lu,%lu,%lu,%lu,%d,%d,%d,%d\n", life_generation, stats.population, stats.births, stats.deaths,
+           stats.x0, stats.y0, stats.x1, stats.y1);
+}
+
+// Time board hash updates, in nanoseconds each. The kernel does one for
+// every word it rewrites, inside the step, so the timing printout puts a
+// figure on hashing from this and the words rewritten.
+uint32_t life_hash_update_ns() {
+    constexpr uint32_t UPDATES = 4096;
+    LifeHash h;
+    uint32_t t0 = time_us_32();
+    for (uint32_t i = 0; i < UPDATES; i++) h.update(i * 0x9E3779B9u, ~i, i);
+    uint32_t us = time_us_32() - t0;
+    volatile uint64_t sink = h.value();
+    (void)sink;
+    return us * 1000 / UPDATES;
+}
+
+// Start the Generations board from the alive cells in the viewport
+void load_generations_from_view() {
+    generations.clear();
+    for (int y = 1; y < LIFE_GENERATIONS_Y - 1; y++) {
+        for (int x = 1; x < LIFE_GENERATIONS_X - 1; x++) {
+            if (life.alive(view_x + x, view_y + y)) generations.set(x, y);
+        }
+    }
+}
+
+// Wait while a button stays pressed; true if it was held for ms
+bool button_held(uint gpio, uint32_t ms) {
+    uint32_t start = millis();
+    while (button_pressed(gpio)) {
+        if (millis() - start >= ms) return true;
+        sleep_ms(10);
+    }
+    return false;
+}
+
+// Switch to another zoom level, keeping the centre of the view where it
+// is; the heat map needs LIFE_HEAT_ZOOM or larger. The pipeline must be
+// stopped.
+void select_life_zoom(int index) {
+    int cx = view_x + zoom->width / 2;
+    int cy = view_y + zoom->height / 2;
+    life_zoom = std::clamp(index, life_heat ? LIFE_HEAT_ZOOM : 0, LIFE_ZOOM_COUNT - 1);
+    zoom = &LIFE_ZOOMS[life_zoom];
+    view_x = std::clamp(cx - zoom->width / 2, 0, LIFE_UNIVERSE_X - zoom->width);
+    view_y = std::clamp(cy - zoom->height / 2, 0, LIFE_UNIVERSE_Y - zoom->height);
+    pipeline.set_view(zoom->width, zoom->height);
+    pipeline.set_origin(view_x, view_y);
+    life_ages.clear();
+    printf("Life: zoom %dpx, %dx%d cells\n", zoom->size, zoom->width, zoom->height);
+}
+
+// Switch to another rule; the board carries on from its current state.
+// The pipeline must be stopped.
+void select_life_rule(int rule) {
+    constexpr int count = LIFE_RULE_COUNT + GENERATIONS_RULE_COUNT;
+    bool was_generations = generations_active();
+    life_rule = (rule + count) % count;
+
+    if (generations_active()) {
+        if (life_zoom != LIFE_GENERATIONS_ZOOM) select_life_zoom(LIFE_GENERATIONS_ZOOM);
+        if (!was_generations) load_generations_from_view();
+        const GenerationsRuleEntry<GenerationsBoard>& entry = GENERATIONS_RULES[life_rule - LIFE_RULE_COUNT];
+        generations_palette = entry.palette;
+        printf("Life: rule %s\n", entry.name);
+    } else {
+        pipeline.set_stepper(LIFE_RULES[life_rule].step);
+        printf("Life: rule %s\n", LIFE_RULES[life_rule].name);
+    }
+}
+
+// What UP/DOWN/A/B do in Game of Life, cycled with C
+enum class LifeControls {
+    Pan,
+    Rule,
+    Zoom
+};
+
+// LifeStats cost the kernel a tally of every word it rewrites, so they
+// are only counted while something shows them
+bool life_stats_wanted() {
+    return life_hud || LIFE_STATS_CSV;
+}
+
 void run_game_of_life() {
     init_life_grid();
-    int frames = 0, fnow = 0, fnext = 1;
-
-    draw_full_life_grid(fnow);
+    life.set_track_stats(life_stats_wanted());
+    select_life_zoom(life_zoom);
+    if (generations_active()) load_generations_from_view();
+    select_life_rule(life_rule);
+    LifeControls controls = LifeControls::Pan;
+    int frames = 0;
+
+    draw_full_life_grid();
     st7789.update(&graphics);
-
-    uint32_t total_calc = 0, total_draw = 0, total_update = 0;
-    uint32_t frame_start = millis();
+    zoom->clear();
+    cycles.reset();
+    life_generation = 0;
+    if (LIFE_STATS_CSV) printf("stats,generation,population,births,deaths,x0,y0,x1,y1\n");
+    if (!generations_active()) pipeline.start();
+
+    uint32_t total_step = 0, total_update = 0, total_tiles = 0, total_windows = 0, total_cycle_us = 0;
+    uint32_t total_births = 0, total_deaths = 0, total_generations = 0, total_hashed = 0;
+    uint32_t hash_ns = life_hash_update_ns();
+    uint64_t frame_start = time_us_64();
+    life_pacer.reset(frame_start);
 
     while (frames < LIFE_FRAMES) {
-        uint32_t t0 = millis();
-        calculate_generation(fnow, fnext);
-        uint32_t t1 = millis();
-        total_calc += (t1 - t0);
-
-        mark_changes(fnow, fnext);
-        draw_changes();
-        uint32_t t2 = millis();
-        total_draw += (t2 - t1);
+        uint64_t t0 = time_us_64();
+        int period = 0;
+        // Generations drawn into the framebuffer before the display update
+        int planned = life_pacer.begin_frame(t0);
+        int stepped = 0;
+        while (stepped < planned && !period) {
+            stepped++;
+            if (generations_active()) {
+                GENERATIONS_RULES[life_rule - LIFE_RULE_COUNT].step(generations, draw_generations_cell);
+                continue;
+            }
+            if (life_heat) {
+                next_life_heat();
+            } else {
+                pipeline.next(zoom->draw);
+            }
+            life_generation++;
+            total_tiles += pipeline.active_tiles();
+            total_hashed += pipeline.hashed_words();
+
+            uint32_t c0 = time_us_32();
+            period = cycles.push(pipeline.hash(), (uint32_t)(t0 / 1000));
+            total_cycle_us += time_us_32() - c0;
+
+            const LifeStats& stats = pipeline.stats();
+            total_births += stats.births;
+            total_deaths += stats.deaths;
+            if (LIFE_STATS_CSV) print_life_stats_csv(stats);
+        }
+        if (life_hud && !generations_active()) draw_life_hud(pipeline.stats());
+        uint64_t t1 = time_us_64();
+        life_pacer.computed(t1, stepped);
+        total_step += (uint32_t)(t1 - t0);
+        total_generations += stepped;
 
-        st7789.update(&graphics);
-        uint32_t t3 = millis();
-        total_update += (t3 - t2);
+        total_windows += zoom->update();
+        if (life_hud && !generations_active()) update_life_hud();
+        uint64_t t2 = time_us_64();
+        total_update += (uint32_t)(t2 - t1);
 
-        fnow = fnext;
-        fnext = 1 - fnext;
         frames++;
 
         if (frames % 50 == 0) {
-            uint32_t elapsed = millis() - frame_start;
-            float fps = 50.0f * 1000.0f / (float)elapsed;
-            printf("Frame %d: calc=%lums draw=%lums update=%lums FPS=%.1f\n",
-                   frames, total_calc, total_draw, total_update, fps);
-            total_calc = total_draw = total_update = 0;
-            frame_start = millis();
+            float elapsed = (float)(t2 - frame_start);
+            printf("Frame %d: zoom=%dpx wait+draw=%lums update=%lums FPS=%.1f gens/s=%.1f gens/frame=%d "
+                   "tiles=%lu/%d windows=%lu hash=%luus cycle-check=%luus",
+                   frames, zoom->size, total_step / 1000, total_update / 1000, 50.0f * 1e6f / elapsed,
+                   (float)total_generations * 1e6f / elapsed, life_pacer.generations_per_frame(),
+                   total_tiles / total_generations, life.TILE_COUNT, total_windows / 50,
+                   total_hashed * hash_ns / 1000, total_cycle_us);
+            if (life_stats_wanted()) {
+                printf(" pop=%lu +%lu -%lu", pipeline.stats().population, total_births, total_deaths);
+            }
+            printf("\n");
+            total_step = total_update = total_tiles = total_windows = total_cycle_us = 0;
+            total_births = total_deaths = total_generations = total_hashed = 0;
+            frame_start = t2;
+        }
+
+        // Hold the frame rate when the frame came in early
+        uint32_t wait = life_pacer.end_frame(t2);
+        if (wait) sleep_us(wait);
+
+        if (period) {
+            stop_life_pipeline();
+            printf("Life: period %d cycle at frame %d, detected %lums after it began\n", period, frames,
+                   (uint32_t)(t0 / 1000) - cycles.cycle_start());
+            revive_life();
+            draw_full_life_grid();
+            st7789.update(&graphics);
+            zoom->clear();
+            cycles.reset();
+            pipeline.start();
         }
 
         if (button_pressed(BUTTON_C)) {
+            if (button_held(BUTTON_C, LIFE_EXIT_HOLD_MS)) {
+                while (button_pressed(BUTTON_C)) sleep_ms(10);
+                sleep_ms(200);
+                break;
+            }
+            controls = controls == LifeControls::Pan ? LifeControls::Rule
+                     : controls == LifeControls::Rule ? LifeControls::Zoom
+                     : LifeControls::Pan;
+            printf("Life: %s controls\n", controls == LifeControls::Pan ? "pan"
+                                          : controls == LifeControls::Rule ? "rule" : "zoom");
+        }
+
+        if (controls == LifeControls::Pan) {
+            int dx = button_pressed(BUTTON_A) ? -LIFE_PAN : button_pressed(BUTTON_B) ? LIFE_PAN : 0;
+            int dy = button_pressed(BUTTON_UP) ? -LIFE_PAN : button_pressed(BUTTON_DOWN) ? LIFE_PAN : 0;
+            if ((dx || dy) && !generations_active()) {
+                view_x = std::clamp(view_x + dx, 0, LIFE_UNIVERSE_X - zoom->width);
+                view_y = std::clamp(view_y + dy, 0, LIFE_UNIVERSE_Y - zoom->height);
+                pipeline.set_origin(view_x, view_y);
+            }
+            continue;
+        }
+
+        if (controls == LifeControls::Zoom) {
+            int zoom_delta = button_pressed(BUTTON_UP) ? 1 : button_pressed(BUTTON_DOWN) ? -1 : 0;
+            int next_zoom = std::clamp(life_zoom + zoom_delta, 0, LIFE_ZOOM_COUNT - 1);
+            bool toggle_hud = button_pressed(BUTTON_A);
+            bool toggle_heat = button_pressed(BUTTON_B);
+            if ((next_zoom != life_zoom || toggle_hud || toggle_heat) && !generations_active()) {
+                stop_life_pipeline();
+                if (toggle_hud) {
+                    life_hud = !life_hud;
+                    life.set_track_stats(life_stats_wanted());
+                }
+                if (toggle_heat) life_heat = !life_heat;
+                select_life_zoom(next_zoom);
+                draw_full_life_grid();
+                st7789.update(&graphics);
+                zoom->clear();
+                pipeline.start();
+                sleep_ms(200);
+            }
+            continue;
+        }
+
+        int rule_delta = button_pressed(BUTTON_UP) ? 1 : button_pressed(BUTTON_DOWN) ? -1 : 0;
+        bool jump = !generations_active() && button_pressed(BUTTON_B);
+        if (rule_delta || jump) {
+            if (!generations_active()) stop_life_pipeline();
+            if (rule_delta) select_life_rule(life_rule + rule_delta);
+            if (jump) fast_forward_life(LIFE_JUMP);
+            draw_full_life_grid();
+            st7789.update(&graphics);
+            zoom->clear();
+            cycles.reset();
+            if (!generations_active()) pipeline.start();
             sleep_ms(200);
-            break;
         }
     }
+
+    if (!generations_active()) stop_life_pipeline();
 }
 
 // ============================================================================
@@ -474,8 +1364,8 @@ void draw_pattern(int pattern_num) {
 // ============================================================================
 
 void draw_name_badge() {
-    // Try to load name badge PNG first
-    if (fs_mounted && load_png("pics/tufty-name.png")) {
+    // Try to load name badge image first, pre-decoded or PNG
+    if ((fs_mounted || image_blob.count()) && (load_image("tufty-name.565") || load_image("tufty-name.png"))) {
         return;  // Successfully loaded
     }
 
@@ -510,6 +1400,7 @@ void draw_name_badge() {
 int main() {
     stdio_init_all();
     init_buttons();
+    enter_image_mode();
 
     // Initialize display early and clear to black
     st7789.set_backlight(200);
@@ -542,6 +1433,7 @@ int main() {
     printf("\n\nTufty 2040 Badge - C++ Version\n");
     printf("Buttons: A=next, B=name badge, C=Game of Life\n");
     printf("Flash size: %d MB\n", PICO_FLASH_SIZE_BYTES / 1024 / 1024);
+    print_ram_usage();
 
     // Mount filesystem
     printf("Mounting filesystem...\n");
@@ -581,11 +1473,21 @@ int main() {
         printf("Scanning for images...\n");
         image_count = scan_images();
         printf("Found %d images in pics/\n", image_count);
+
+        printf("Scanning for Life patterns...\n");
+        pattern_count = scan_patterns();
+        printf("Found %d patterns in life/\n", pattern_count);
+        load_life_seed();
     } else {
         printf("Filesystem mount failed - using patterns\n");
         fs_mounted = false;
     }
 
+    if (image_blob.open((const uint8_t*)(XIP_BASE + IMAGE_BLOB_OFFSET), IMAGE_BLOB_SIZE)) {
+        printf("Image blob: %d entries at 0x%08X\n", image_blob.count(), (unsigned int)(XIP_BASE + IMAGE_BLOB_OFFSET));
+        image_count = scan_blob_images(image_count);
+    }
+
     rand_seed = millis();
     int image_index = 0;
 
@@ -606,18 +1508,36 @@ int main() {
         tufty.led(128);
 
         bool loaded = false;
-        if (fs_mounted && image_count > 0) {
-            char filename[64];
-            snprintf(filename, sizeof(filename), "pics/%s", image_list[image_index]);
-            printf("Loading: %s\n", filename);
-            loaded = load_png(filename);
+        if (image_count > 0) {
+            uint32_t t0 = time_us_32();
+            if (prefetcher.take(image_index, (uint16_t*)graphics.frame_buffer)) {
+                printf("Loading: %s, prefetched (%d bytes staged) in %luus\n", image_list[image_index],
+                       prefetcher.staged_bytes(), time_us_32() - t0);
+                loaded = true;
+            } else {
+                printf("Loading: %s\n", image_list[image_index]);
+                loaded = load_image(image_list[image_index]);
+            }
         }
 
         if (!loaded) {
             draw_pattern(image_index);
         }
 
-        st7789.update(&graphics);
+        // Pick the next image now, so core1 can decode it while this one
+        // is sent to the display and on show
+        int next_index = image_index;
+        if (image_count > 1) {
+            do {
+                next_index = fast_rand() % image_count;
+            } while (next_index == image_index);  // Avoid showing same image twice
+        } else if (image_count == 0) {
+            // No images found, pick random pattern
+            next_index = fast_rand() % 72;
+        }
+        if (image_count > 0) prefetcher.request(next_index);
+
+        show_frame();
         tufty.led(0);
 
         uint32_t start_time = millis();
@@ -625,6 +1545,7 @@ int main() {
 
         while (millis() - start_time < display_time) {
             sleep_ms(100);
+            poll_usb_command();
 
             if (button_pressed(BUTTON_A)) {
                 sleep_ms(200);
@@ -632,9 +1553,10 @@ int main() {
             }
 
             if (button_pressed(BUTTON_B)) {
+                prefetcher.cancel();
                 tufty.led(128);
                 draw_name_badge();
-                st7789.update(&graphics);
+                show_frame();
                 tufty.led(0);
 
                 uint32_t badge_start = millis();
@@ -650,22 +1572,14 @@ int main() {
 
             if (button_pressed(BUTTON_C)) {
                 sleep_ms(200);
+                enter_life_mode();
                 run_game_of_life();
+                enter_image_mode();
                 break;
             }
         }
 
-        // Pick random next image
-        if (image_count > 1) {
-            int new_index;
-            do {
-                new_index = fast_rand() % image_count;
-            } while (new_index == image_index);  // Avoid showing same image twice
-            image_index = new_index;
-        } else if (image_count == 0) {
-            // No images found, pick random pattern
-            image_index = fast_rand() % 72;
-        }
+        image_index = next_index;
     }
 
     return 0;